@@ -0,0 +1,130 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#include "ConnectionSettings.hxx"
+#include "Logger.hxx"
+
+#include <strings.h>
+#include <algorithm>
+
+#define DEFAULT_PDU_SIZE 240  // PDU of the S7-200 CPUs and CP243-1
+
+namespace Common {
+
+    std::atomic<unsigned> ConnectionSettings::_generation{0};
+
+    ConnectionSettings::ConnectionSettings()
+        : localTsap(0), remoteTsap(0), connections(1), pduSize(DEFAULT_PDU_SIZE), pollingInterval(1),
+          connectTimeout(0), sendTimeout(0), recvTimeout(0), coalesceGap(0), maxFrames(0), mirror(false),
+          keepaliveIdle(0), callDeadline(0), writeFrameRate(0), writeByteRate(0),
+          scanTimeInterval(0), scanTimeCeiling(0)
+    {
+    }
+
+    bool ConnectionSettings::set(const std::string& key, const std::string& value)
+    {
+        const char* k = key.c_str();
+        if(strcasecmp(k, "localTSAP") == 0)
+            localTsap = strtol(value.c_str(), NULL, 16);
+        else if(strcasecmp(k, "remoteTSAP") == 0)
+            remoteTsap = strtol(value.c_str(), NULL, 16);
+        else if(strcasecmp(k, "connections") == 0)
+            connections = std::max(1, atoi(value.c_str()));
+        else if(strcasecmp(k, "pduSize") == 0)
+            pduSize = atoi(value.c_str());
+        else if(strcasecmp(k, "pollingInterval") == 0)
+            pollingInterval = atoi(value.c_str());
+        else if(strcasecmp(k, "connectTimeout") == 0)
+            connectTimeout = atoi(value.c_str());
+        else if(strcasecmp(k, "sendTimeout") == 0)
+            sendTimeout = atoi(value.c_str());
+        else if(strcasecmp(k, "recvTimeout") == 0)
+            recvTimeout = atoi(value.c_str());
+        else if(strcasecmp(k, "coalesceGap") == 0)
+            coalesceGap = atoi(value.c_str());
+        else if(strcasecmp(k, "maxFrames") == 0)
+            maxFrames = atoi(value.c_str());
+        else if(strcasecmp(k, "mirror") == 0)
+            mirror = atoi(value.c_str()) != 0;
+        else if(strcasecmp(k, "keepaliveIdle") == 0)
+            keepaliveIdle = atoi(value.c_str());
+        else if(strcasecmp(k, "callDeadline") == 0)
+            callDeadline = atoi(value.c_str());
+        else if(strcasecmp(k, "writeFrameRate") == 0)
+            writeFrameRate = atoi(value.c_str());
+        else if(strcasecmp(k, "writeByteRate") == 0)
+            writeByteRate = atoi(value.c_str());
+        else if(strcasecmp(k, "scanTimeInterval") == 0)
+            scanTimeInterval = atoi(value.c_str());
+        else if(strcasecmp(k, "scanTimeCeiling") == 0)
+            scanTimeCeiling = atoi(value.c_str());
+        else
+            return false;
+        return true;
+    }
+
+    bool ConnectionSettings::setDefault(const std::string& key, const std::string& value)
+    {
+        std::lock_guard<std::mutex> lock{mutex()};
+        if(!defaults().set(key, value))
+            return false;
+        _generation++;
+        return true;
+    }
+
+    bool ConnectionSettings::setOverride(const std::string& ip, const std::string& key, const std::string& value)
+    {
+        // validate the key word now, apply it in compile() on top of the driver-wide values
+        ConnectionSettings check;
+        if(!check.set(key, value))
+            return false;
+
+        std::lock_guard<std::mutex> lock{mutex()};
+        overrides()[ip].push_back(std::make_pair(key, value));
+        return true;
+    }
+
+    ConnectionSettings ConnectionSettings::compile(const std::string& ip)
+    {
+        std::lock_guard<std::mutex> lock{mutex()};
+        ConnectionSettings settings = defaults();
+
+        auto it = overrides().find(ip);
+        if(it != overrides().end())
+        {
+            for(const auto& entry : it->second)
+                settings.set(entry.first, entry.second);
+            S7200_LOG_INFO(Logger::L1, "Using ", it->second.size(), " specific setting(s) for PLC ", ip);
+        }
+        return settings;
+    }
+
+    ConnectionSettings& ConnectionSettings::defaults()
+    {
+        static ConnectionSettings settings;
+        return settings;
+    }
+
+    std::map<std::string, std::vector<std::pair<std::string, std::string>>>& ConnectionSettings::overrides()
+    {
+        static std::map<std::string, std::vector<std::pair<std::string, std::string>>> perIp;
+        return perIp;
+    }
+
+    std::mutex& ConnectionSettings::mutex()
+    {
+        static std::mutex m;
+        return m;
+    }
+}
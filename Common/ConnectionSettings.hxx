@@ -0,0 +1,81 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#ifndef CONNECTIONSETTINGS_HXX_
+#define CONNECTIONSETTINGS_HXX_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+
+namespace Common{
+
+    /*!
+    * \class ConnectionSettings
+    * \brief Settings of the link to one PLC
+    *
+    * The driver-wide values come from the [s7200] section of the config file. They can be
+    * overridden for one PLC in a section named after its IP address, e.g. [s7200.172.18.130.170].
+    * compile() merges both for a given IP when its polling thread starts. The driver-wide values
+    * can also be changed at runtime (see Constants::parse_map): generation() then changes and the
+    * polling threads compile their settings again.
+    */
+    struct ConnectionSettings{
+        uint32_t localTsap;
+        uint32_t remoteTsap;
+        int connections;        // connections opened to the PLC
+        int pduSize;            // cap on the PDU size, the negotiated PDU is used if smaller
+        size_t pollingInterval; // minimum polling period (s)
+        int connectTimeout;     // ms, 0 = snap7 default
+        int sendTimeout;        // ms, 0 = snap7 default
+        int recvTimeout;        // ms, 0 = snap7 default
+        int coalesceGap;        // max gap (bytes) between two items read with one request
+        int maxFrames;          // max read requests per polling cycle, 0 = unlimited
+        bool mirror;            // read the used V memory as blocks and decode the V addresses from this copy
+        int keepaliveIdle;      // s without answer from the PLC before it is probed, 0 = no probe
+        int callDeadline;       // ms a snap7 call may last before the watchdog closes the connection, 0 = no watchdog
+        int writeFrameRate;     // max write requests per second, 0 = unlimited
+        int writeByteRate;      // max bytes written per second, 0 = unlimited
+        int scanTimeInterval;   // s between two reads of the scan time of the PLC, 0 = not read
+        int scanTimeCeiling;    // ms of scan time above which the slow addresses are stretched, 0 = no ceiling
+
+        ConnectionSettings();
+
+        /*!
+         * Set one setting from its config file key word
+         * \return false if the key word is unknown
+         */
+        bool set(const std::string& key, const std::string& value);
+
+        // Set a driver-wide value, for the key words of the [s7200] section not stored in Constants
+        static bool setDefault(const std::string& key, const std::string& value);
+        // Set a value for one PLC, from a [s7200.<ip>] section
+        static bool setOverride(const std::string& ip, const std::string& key, const std::string& value);
+        // The settings to use for the PLC with this IP
+        static ConnectionSettings compile(const std::string& ip);
+        // Incremented every time a driver-wide value changes
+        static unsigned generation() {return _generation;}
+
+    private:
+        static ConnectionSettings& defaults();
+        static std::map<std::string, std::vector<std::pair<std::string, std::string>>>& overrides();
+        static std::mutex& mutex();
+        static std::atomic<unsigned> _generation;
+    };
+
+}//namespace
+#endif /* CONNECTIONSETTINGS_HXX_ */
@@ -15,6 +15,7 @@
 #include "Constants.hxx"
 #include "Logger.hxx"
 #include "Utils.hxx"
+#include "ConnectionSettings.hxx"
 #include <cstring>
 
 namespace Common {
@@ -24,37 +25,56 @@ namespace Common {
     uint32_t Constants::TSAP_PORT_LOCAL = 0;                // Read from PVSS on driver startup from config file
     uint32_t Constants::TSAP_PORT_REMOTE = 0;               // Read from PVSS on driver startupconfig file
     size_t Constants::POLLING_INTERVAL = 1;                 // Read from PVSS on driver startupconfig file
+    std::atomic<size_t> Constants::WORKPROC_BUDGET{0};      // Max values sent to WinCC OA per workProc, 0 = unlimited
+    size_t Constants::STANDBY_POLLING_INTERVAL = 0;         // Read from PVSS on driver startupconfig file, 0 = passive node does not poll
+    size_t Constants::VALUE_STORE_SLOTS = 0;                // Read from PVSS on driver startupconfig file, 0 = no value store
+    size_t Constants::SNAPSHOT_INTERVAL = 0;                // Read from PVSS on driver startupconfig file, 0 = no warm-start snapshot
     std::string Constants::drv_version = "1.1";
 
-    // The map can be used to map a callback to a HwObject address
-    std::map<std::string, std::function<void(const char*)>> Constants::parse_map =
+    // The map can be used to map a callback to a HwObject address: these are the settings that can be changed at runtime
+    // through the CONFIG DPEs. A callback returns false if the value is rejected.
+    std::map<std::string, std::function<bool(int32_t)>> Constants::parse_map =
     {
         {   "_DEBUGLVL",
-            [](const char* data)
+            [](int32_t value) -> bool
             {
-                Common::Logger::globalInfo(Common::Logger::L1, "setLogLvl:", std::to_string(*data).c_str());
-                Common::Logger::setLogLvl(std::stoi(std::to_string(*data)));
-
+                if(value < Logger::L1 || value > Logger::L3)
+                    return false;
+                S7200_LOG_INFO(Common::Logger::L1, "setLogLvl:", value);
+                Common::Logger::setLogLvl(value);
+                return true;
             }
-        }
-        
-        /*
-        ,
-        {   "DEBOUNCINGTHREADINTERVAL",
-            [](const char* data)
+        },
+        {   "_POLLINGINTERVAL",
+            [](int32_t value) -> bool
+            {
+                if(value <= 0)
+                    return false;
+                Common::Constants::setPollingInterval(value);
+                return ConnectionSettings::setDefault("pollingInterval", std::to_string(value));
+            }
+        },
+        {   "_MAXFRAMES",
+            [](int32_t value) -> bool
             {
-							Common::Logger::globalInfo(Common::Logger::L1, "setDebouncingThreadInterval:", CharString(data));
-              Common::Constants::setDebouncingThreadInterval((int)std::atoi(data));
+                return value >= 0 && ConnectionSettings::setDefault("maxFrames", std::to_string(value));
             }
         },
-        {   "MAXPOLLRECORDS",
-            [](const char* data)
+        {   "_COALESCEGAP",
+            [](int32_t value) -> bool
             {
-							Common::Logger::globalInfo(Common::Logger::L1, "setConsumerMaxPollRecords:", CharString(data));
-              Common::Constants::setConsumerMaxPollRecords((size_t)std::atoi(data));
+                return value >= 0 && ConnectionSettings::setDefault("coalesceGap", std::to_string(value));
+            }
+        },
+        {   "_WORKPROC_BUDGET",
+            [](int32_t value) -> bool
+            {
+                if(value < 0)
+                    return false;
+                S7200_LOG_INFO(Common::Logger::L1, "setWorkProcBudget:", value);
+                Common::Constants::setWorkProcBudget(value);
+                return true;
             }
         }
-        */
-
     };
 }
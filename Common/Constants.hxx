@@ -24,6 +24,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <memory>
+#include <atomic>
+#include <functional>
 #include <map>
 #include <Common/Utils.hxx>
 #include <Common/Logger.hxx>
@@ -55,6 +57,18 @@ namespace Common{
 
         static void setPollingInterval(size_t pollingInterval);
         static const size_t& getPollingInterval();
+
+        static void setWorkProcBudget(size_t budget);
+        static size_t getWorkProcBudget();
+
+        static void setStandbyPollingInterval(size_t standbyPollingInterval);
+        static const size_t& getStandbyPollingInterval();
+
+        static void setValueStoreSlots(size_t slots);
+        static const size_t& getValueStoreSlots();
+
+        static void setSnapshotInterval(size_t interval);
+        static const size_t& getSnapshotInterval();
         
         static void setUserFilePath(std::string);
         static std::string& getUserFilePath();
@@ -65,7 +79,7 @@ namespace Common{
         static void setEventFilePath(std::string);
         static std::string& getEventFilePath();
 
-        static const std::map<std::string,std::function<void(const char *)>>& GetParseMap();
+        static const std::map<std::string,std::function<bool(int32_t)>>& GetParseMap();
         static std::string MEASUREMENT_PATH;
         static std::string EVENT_PATH;
         static std::string USERFILE_PATH;
@@ -78,11 +92,15 @@ namespace Common{
         static uint32_t TSAP_PORT_LOCAL;
         static uint32_t TSAP_PORT_REMOTE;
         static size_t POLLING_INTERVAL;
+        static size_t STANDBY_POLLING_INTERVAL;
+        static size_t VALUE_STORE_SLOTS;
+        static size_t SNAPSHOT_INTERVAL;
+        static std::atomic<size_t> WORKPROC_BUDGET;
 
-        static std::map<std::string, std::function<void(const char *)>> parse_map;
+        static std::map<std::string, std::function<bool(int32_t)>> parse_map;
     };
 
-    inline const std::map<std::string,std::function<void(const char *)>>& Constants::GetParseMap()
+    inline const std::map<std::string,std::function<bool(int32_t)>>& Constants::GetParseMap()
     {
         return parse_map;
     }
@@ -108,7 +126,7 @@ namespace Common{
     }
 
     inline void Constants::setLocalTsapPort(uint32_t port){
-        Common::Logger::globalInfo(Common::Logger::L1,"Setting TSAP_PORT_LOCAL=" + CharString(port));
+        S7200_LOG_INFO(Common::Logger::L1, "Setting TSAP_PORT_LOCAL=", port);
         //printf("Setting TSAP_PORT_LOCAL=" + CharString(port) + "\n");
         TSAP_PORT_LOCAL = port;
     }
@@ -118,7 +136,7 @@ namespace Common{
     }
 
     inline void Constants::setRemoteTsapPort(uint32_t port){
-        Common::Logger::globalInfo(Common::Logger::L1,"Setting TSAP_PORT_REMOTE=" + CharString(port));
+        S7200_LOG_INFO(Common::Logger::L1, "Setting TSAP_PORT_REMOTE=", port);
         //printf("Setting TSAP_PORT_REMOTE=" + CharString(port) + "\n");
         TSAP_PORT_REMOTE = port;
     }
@@ -138,6 +156,49 @@ namespace Common{
         return POLLING_INTERVAL;
     }
 
+    inline void Constants::setWorkProcBudget(size_t budget)
+    {
+        WORKPROC_BUDGET = budget;
+    }
+
+    inline size_t Constants::getWorkProcBudget()
+    {
+        return WORKPROC_BUDGET;
+    }
+
+    inline void Constants::setStandbyPollingInterval(size_t standbyPollingInterval)
+    {
+        S7200_LOG_INFO(Common::Logger::L1, "Setting STANDBY_POLLING_INTERVAL=", standbyPollingInterval);
+        STANDBY_POLLING_INTERVAL = standbyPollingInterval;
+    }
+
+    inline const size_t& Constants::getStandbyPollingInterval()
+    {
+        return STANDBY_POLLING_INTERVAL;
+    }
+
+    inline void Constants::setValueStoreSlots(size_t slots)
+    {
+        S7200_LOG_INFO(Common::Logger::L1, "Setting VALUE_STORE_SLOTS=", slots);
+        VALUE_STORE_SLOTS = slots;
+    }
+
+    inline const size_t& Constants::getValueStoreSlots()
+    {
+        return VALUE_STORE_SLOTS;
+    }
+
+    inline void Constants::setSnapshotInterval(size_t interval)
+    {
+        S7200_LOG_INFO(Common::Logger::L1, "Setting SNAPSHOT_INTERVAL=", interval);
+        SNAPSHOT_INTERVAL = interval;
+    }
+
+    inline const size_t& Constants::getSnapshotInterval()
+    {
+        return SNAPSHOT_INTERVAL;
+    }
+
     inline void Constants::setUserFilePath(std::string userFilePath) 
     { 
         //printf("Setting USERFILE_PATH= %s\n", userFilePath.c_str());
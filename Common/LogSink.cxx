@@ -0,0 +1,127 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#include "LogSink.hxx"
+
+#include <ErrHdl.hxx>
+#include <ErrClass.hxx>
+
+namespace Common {
+
+LogSink& LogSink::getInstance()
+{
+    static LogSink sink;
+    return sink;
+}
+
+LogSink::~LogSink()
+{
+    stop();
+}
+
+void LogSink::start(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    if(_running)
+        return;
+
+    _capacity = capacity;
+    _running = true;
+    _thread = std::thread(&LogSink::run, this);
+}
+
+void LogSink::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        if(!_running)
+            return;
+        _running = false;
+    }
+    _cv.notify_one();
+
+    if(_thread.joinable())
+        _thread.join();
+}
+
+bool LogSink::push(int prio, const char *note1, const char* note2, const char* note3)
+{
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        if(!_running)
+            return false;
+
+        if(_queue.size() >= _capacity)
+        {
+            _dropped++;
+            return true;
+        }
+
+        _queue.emplace_back();
+        Record& record = _queue.back();
+        record.prio = prio;
+        const char* notes[3] = {note1, note2, note3};
+        for(int i = 0; i < 3; i++)
+        {
+            record.hasNote[i] = notes[i] != NULL;
+            if(notes[i])
+                record.notes[i] = notes[i];
+        }
+    }
+    _cv.notify_one();
+    return true;
+}
+
+void LogSink::run()
+{
+    std::unique_lock<std::mutex> lock{_mutex};
+    while(_running || !_queue.empty())
+    {
+        _cv.wait(lock, [this]{ return !_running || !_queue.empty(); });
+
+        std::deque<Record> batch;
+        batch.swap(_queue);
+        lock.unlock();
+
+        for(const auto& record : batch)
+            deliver(record);
+
+        uint64_t dropped = _dropped;
+        if(dropped != _reportedDropped)
+        {
+            ErrHdl::error(
+                    ErrClass::PRIO_WARNING,
+                    ErrClass::ERR_CONTROL,
+                    ErrClass::NOERR,
+                    "LogSink: log queue full, messages dropped so far:",
+                    std::to_string(dropped).c_str());
+            _reportedDropped = dropped;
+        }
+
+        lock.lock();
+    }
+}
+
+void LogSink::deliver(const Record& record)
+{
+    ErrHdl::error(
+            (ErrClass::ErrPrio) record.prio,
+            ErrClass::ERR_CONTROL,
+            ErrClass::NOERR,
+            record.hasNote[0] ? record.notes[0].c_str() : NULL,
+            record.hasNote[1] ? record.notes[1].c_str() : NULL,
+            record.hasNote[2] ? record.notes[2].c_str() : NULL);
+}
+
+}
@@ -0,0 +1,91 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#ifndef LOGSINK_HXX
+#define LOGSINK_HXX
+
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <stdint.h>
+
+namespace Common {
+
+/*!
+ * \class LogSink
+ * \brief Asynchronous delivery of log messages to ErrHdl
+ *
+ * The I/O threads only copy the notes into a bounded queue; a single thread calls
+ * ErrHdl::error. When the queue is full the message is dropped and counted, the
+ * count is reported by the sink thread once it catches up.
+ */
+class LogSink
+{
+public:
+    static LogSink& getInstance();
+
+    ~LogSink();
+
+    /*!
+     * Start the sink thread
+     * \param capacity maximum number of queued messages
+     */
+    void start(size_t capacity = DEFAULT_CAPACITY);
+
+    /*!
+     * Deliver the queued messages and stop the sink thread
+     */
+    void stop();
+
+    /*!
+     * Queue a message
+     * \return false if the sink is not running, the caller must then log synchronously
+     */
+    bool push(int prio, const char *note1, const char* note2, const char* note3);
+
+    uint64_t getDropped() const {return _dropped;}
+
+    static const size_t DEFAULT_CAPACITY = 4096;
+
+private:
+    LogSink() {}
+    LogSink(LogSink const&) = delete;
+    void operator= (LogSink const&) = delete;
+
+    struct Record
+    {
+        int prio;
+        std::string notes[3];
+        bool hasNote[3];
+    };
+
+    void run();
+    static void deliver(const Record& record);
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<Record> _queue;
+    size_t _capacity{DEFAULT_CAPACITY};
+    bool _running{false};
+    std::thread _thread;
+    std::atomic<uint64_t> _dropped{0};
+    uint64_t _reportedDropped{0};
+};
+
+}
+
+#endif // LOGSINK_HXX
@@ -14,6 +14,7 @@
 
 #include "Logger.hxx"
 #include "Common/Constants.hxx"
+#include "Common/LogSink.hxx"
 #include <mutex>
 
 namespace Common {
@@ -22,7 +23,7 @@ int16_t Logger::loggingLevel = 1;
 const char * Logger::timestrformat = "%a, %d.%m.%Y %H:%M:%S";
 
 void Logger::globalInfo(int lvl, const char *note1, const char* note2, const char* note3){
-	if(loggingLevel > 0 && loggingLevel >= lvl){
+	if(isEnabled(lvl) && !LogSink::getInstance().push(ErrClass::PRIO_INFO, note1, note2, note3)){
 		ErrHdl::error(
 				ErrClass::PRIO_INFO,
 				ErrClass::ERR_CONTROL,
@@ -34,7 +35,7 @@ void Logger::globalInfo(int lvl, const char *note1, const char* note2, const cha
 }
 
 void Logger::globalWarning(const char *note1, const char* note2, const char* note3){
-	if(loggingLevel > L0){
+	if(loggingLevel > L0 && !LogSink::getInstance().push(ErrClass::PRIO_WARNING, note1, note2, note3)){
 		ErrHdl::error(
 				ErrClass::PRIO_WARNING,
 				ErrClass::ERR_CONTROL,
@@ -45,6 +46,7 @@ void Logger::globalWarning(const char *note1, const char* note2, const char* not
 	}
 }
 
+// Fatal messages stop the manager: they are never queued
 void Logger::globalError(const char *note1, const char* note2, const char* note3){
 	if(loggingLevel > L0){
 		ErrHdl::error(
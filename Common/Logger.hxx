@@ -22,10 +22,22 @@
 #include <ErrClass.hxx>
 
 #include <mutex>
+#include <sstream>
+#include <string>
 
 using std::mutex;
 using std::lock_guard;
 
+/*!
+ * Level gated logging: the arguments are only evaluated and formatted if the level is enabled.
+ * e.g. S7200_LOG_INFO(Common::Logger::L3, "Erased address: ", var, " on IP: ", ip);
+ */
+#define S7200_LOG_INFO(lvl, ...) \
+	do { if(Common::Logger::isEnabled(lvl)) Common::Logger::globalInfo(lvl, Common::Logger::format(__VA_ARGS__).c_str()); } while(0)
+
+#define S7200_LOG_WARNING(...) \
+	do { if(Common::Logger::isEnabled(Common::Logger::L1)) Common::Logger::globalWarning(Common::Logger::format(__VA_ARGS__).c_str()); } while(0)
+
 namespace Common {
 
 /*!
@@ -71,8 +83,31 @@ public:
     static const int L4 = 4;
 
     static const int getLogLevel();
+
+	/*!
+	 * Check if a level is logged, to be called before building any message
+	 * \param lvl logging level
+	 */
+	static bool isEnabled(int lvl);
+
+	/*!
+	 * Concatenate the arguments into one message
+	 */
+	template <typename... Args>
+	static std::string format(const Args&... args);
+
 private:
 
+	static void formatTo(std::ostringstream&) {}
+
+	template <typename T, typename... Args>
+	static void formatTo(std::ostringstream& os, const T& value, const Args&... args);
+
+	static void append(std::ostringstream& os, const CharString& value) {os << value.c_str();}
+
+	template <typename T>
+	static void append(std::ostringstream& os, const T& value) {os << value;}
+
 	std::fstream& getStream();
 
 	void closeStream();
@@ -104,6 +139,23 @@ inline const int Logger::getLogLevel(){
     return loggingLevel;
 }
 
+inline bool Logger::isEnabled(int lvl){
+	return loggingLevel > L0 && loggingLevel >= lvl;
+}
+
+template <typename... Args>
+std::string Logger::format(const Args&... args){
+	std::ostringstream os;
+	formatTo(os, args...);
+	return os.str();
+}
+
+template <typename T, typename... Args>
+void Logger::formatTo(std::ostringstream& os, const T& value, const Args&... args){
+	append(os, value);
+	formatTo(os, args...);
+}
+
 inline void Logger::setDevNum(int num){
     lock_guard<mutex> raiiLock(localVariableDataAccess);
 	devNum = num;
@@ -0,0 +1,104 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#ifndef STRINGCODEC_HXX
+#define STRINGCODEC_HXX
+
+#include <cstddef>
+#include <cstring>
+
+namespace Common {
+
+/*!
+ * \class StringCodec
+ * \brief Length-bounded codec for PLC character buffers.
+ *
+ * PLC buffers are never assumed to be NUL terminated: every function takes the
+ * buffer size explicitly. Two layouts are supported:
+ *  - plain : the characters, padded with NUL up to the buffer size (e.g. VB100.40)
+ *  - S7 STRING : a 2 bytes header (max length, actual length) followed by the
+ *    characters (e.g. VB100.40S)
+ */
+class StringCodec
+{
+public:
+    static const size_t S7_HEADER_SIZE = 2;
+    static const size_t S7_MAX_LENGTH = 254;
+
+    /*!
+     * Locate the characters of a string held in a PLC buffer
+     * \param buffer PLC buffer
+     * \param size size of the PLC buffer
+     * \param s7Header true if the buffer starts with an S7 STRING header
+     * \param length set to the number of valid characters
+     * \return pointer to the first character (inside buffer)
+     */
+    static const char* decode(const unsigned char* buffer, size_t size, bool s7Header, size_t& length)
+    {
+        length = 0;
+        if(buffer == NULL)
+            return NULL;
+
+        if(!s7Header)
+        {
+            const void* nul = std::memchr(buffer, '\0', size);
+            length = nul ? static_cast<const unsigned char*>(nul) - buffer : size;
+            return reinterpret_cast<const char*>(buffer);
+        }
+
+        if(size < S7_HEADER_SIZE)
+            return reinterpret_cast<const char*>(buffer);
+
+        size_t capacity = size - S7_HEADER_SIZE;
+        length = buffer[1];
+        if(length > buffer[0])
+            length = buffer[0];
+        if(length > capacity)
+            length = capacity;
+        return reinterpret_cast<const char*>(buffer + S7_HEADER_SIZE);
+    }
+
+    /*!
+     * Encode a string into a PLC buffer, padding the remaining bytes with NUL
+     * \param buffer PLC buffer
+     * \param size size of the PLC buffer
+     * \param s7Header true if an S7 STRING header must be written
+     * \param value characters to encode
+     * \param length number of characters to encode
+     * \return false if the string does not fit in the buffer
+     */
+    static bool encode(unsigned char* buffer, size_t size, bool s7Header, const char* value, size_t length)
+    {
+        size_t offset = s7Header ? S7_HEADER_SIZE : 0;
+        if(buffer == NULL || size < offset || length > size - offset)
+            return false;
+
+        if(s7Header)
+        {
+            size_t capacity = size - offset;
+            if(length > S7_MAX_LENGTH)
+                return false;
+            buffer[0] = static_cast<unsigned char>(capacity > S7_MAX_LENGTH ? S7_MAX_LENGTH : capacity);
+            buffer[1] = static_cast<unsigned char>(length);
+        }
+
+        std::memcpy(buffer + offset, value, length);
+        std::memset(buffer + offset + length, 0, size - offset - length);
+        return true;
+    }
+};
+
+}
+
+#endif // STRINGCODEC_HXX
@@ -0,0 +1,131 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#include "ValueStore.hxx"
+#include "Logger.hxx"
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <chrono>
+
+namespace Common {
+
+ValueStore& ValueStore::getInstance()
+{
+    static ValueStore instance;
+    return instance;
+}
+
+ValueStore::~ValueStore()
+{
+    close();
+}
+
+bool ValueStore::open(const std::string& path, uint32_t slotCount)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    if(_header != NULL || slotCount == 0)
+        return false;
+
+    size_t size = sizeof(Header) + slotCount * sizeof(Slot);
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0 || ftruncate(fd, size) != 0) {
+        Logger::globalWarning(__PRETTY_FUNCTION__, "Cannot create the value store", path.c_str());
+        if(fd >= 0)
+            ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(mapped == MAP_FAILED) {
+        Logger::globalWarning(__PRETTY_FUNCTION__, "Cannot map the value store", path.c_str());
+        return false;
+    }
+
+    _mappedSize = size;
+    _header = static_cast<Header*>(mapped);
+    _table = reinterpret_cast<Slot*>(static_cast<char*>(mapped) + sizeof(Header));
+    _header->version = VERSION;
+    _header->headerSize = sizeof(Header);
+    _header->slotSize = sizeof(Slot);
+    _header->slotCount = slotCount;
+    _header->valueCapacity = VALUE_CAPACITY;
+    _header->slotsUsed = 0;
+    // the magic is written last: readers ignore the file until the header is complete
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    std::memcpy(_header->magic, "S7200LV", 8);
+
+    Logger::globalInfo(Logger::L1, __PRETTY_FUNCTION__, "Value store:", path.c_str());
+    return true;
+}
+
+void ValueStore::close()
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    if(_header == NULL)
+        return;
+    munmap(_header, _mappedSize);
+    _header = NULL;
+    _table = NULL;
+    _slots.clear();
+}
+
+int ValueStore::slot(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    if(_header == NULL)
+        return -1;
+
+    auto found = _slots.find(key);
+    if(found != _slots.end())
+        return found->second;
+
+    if(_header->slotsUsed >= _header->slotCount) {
+        Logger::globalWarning(__PRETTY_FUNCTION__, "Value store full, not stored:", key.c_str());
+        _slots[key] = -1;
+        return -1;
+    }
+
+    int index = _header->slotsUsed;
+    Slot& slot = _table[index];
+    std::strncpy(slot.key, key.c_str(), KEY_SIZE - 1);
+    // the slot is complete before readers count it
+    __atomic_store_n(&_header->slotsUsed, index + 1, __ATOMIC_RELEASE);
+    _slots[key] = index;
+    return index;
+}
+
+void ValueStore::update(int index, const void* value, size_t size, int64_t timestamp)
+{
+    // the table is only unmapped when the polling threads are stopped
+    if(index < 0 || _table == NULL)
+        return;
+
+    Slot& slot = _table[index];
+    uint32_t sequence = slot.sequence;
+    __atomic_store_n(&slot.sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    slot.size = size;
+    slot.timestamp = timestamp != 0 ? timestamp :
+                     std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    std::memcpy(slot.value, value, size < VALUE_CAPACITY ? size : VALUE_CAPACITY);
+
+    __atomic_store_n(&slot.sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+}
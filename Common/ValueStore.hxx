@@ -0,0 +1,100 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#ifndef VALUESTORE_HXX
+#define VALUESTORE_HXX
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace Common {
+
+/*!
+ * \class ValueStore
+ * \brief Last raw value of every polled address, in a memory-mapped file readable by local tools
+ *
+ * Layout (version 1, host byte order):
+ *  - Header : magic "S7200LV\0", version, header size, slot size, slot count, value capacity,
+ *             slots in use
+ *  - Slots  : sequence, value size, timestamp (ns since the Unix epoch), key "<IP>$<ADDRESS>",
+ *             value (raw PLC bytes, truncated to the capacity when the value size is larger)
+ *
+ * Each slot is written by the polling thread of its PLC under a seqlock: the sequence is odd
+ * while the slot is written. A reader copies a slot when the sequence is even and the same
+ * before and after the copy, otherwise it copies it again.
+ */
+class ValueStore
+{
+public:
+    static const uint32_t VERSION = 1;
+    static const size_t KEY_SIZE = 64;
+    static const size_t VALUE_CAPACITY = 256;   // an S7 STRING fits
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t slotSize;
+        uint32_t slotCount;
+        uint32_t valueCapacity;
+        uint32_t slotsUsed;
+    };
+
+    struct Slot
+    {
+        uint32_t sequence;
+        uint32_t size;
+        int64_t timestamp;
+        char key[KEY_SIZE];
+        unsigned char value[VALUE_CAPACITY];
+    };
+
+    static ValueStore& getInstance();
+
+    ~ValueStore();
+
+    /*!
+     * Create the file and map it
+     * \return false if the file cannot be created, the store then stays closed
+     */
+    bool open(const std::string& path, uint32_t slotCount);
+    void close();
+
+    /*!
+     * Slot of an address, allocated on first use
+     * \return -1 if the store is closed or full
+     */
+    int slot(const std::string& key);
+
+    // Publish the last value of a slot, read now unless a timestamp (ns since the Unix epoch) is given.
+    // Does nothing for slot -1
+    void update(int slot, const void* value, size_t size, int64_t timestamp = 0);
+
+private:
+    ValueStore() = default;
+
+    std::mutex _mutex;
+    std::map<std::string, int> _slots;
+    Header* _header{NULL};
+    Slot* _table{NULL};
+    size_t _mappedSize{0};
+};
+
+}
+
+#endif // VALUESTORE_HXX
@@ -13,12 +13,7 @@
  **/
 
 #include "S7200HWMapper.hxx"
-#include "Transformations/S7200StringTrans.hxx"
-#include "Transformations/S7200Int16Trans.hxx"
-#include "Transformations/S7200Int32Trans.hxx"
-#include "Transformations/S7200FloatTrans.hxx"
-#include "Transformations/S7200BoolTrans.hxx"
-#include "Transformations/S7200Uint8Trans.hxx"
+#include "Transformations/S7200TransFactory.hxx"
 #include "S7200HWService.hxx"
 
 #include <algorithm>
@@ -36,7 +31,7 @@ PVSSboolean S7200HWMapper::addDpPa(DpIdentifier &dpId, PeriphAddr *confPtr)
   // Otherwise we had to look if we already have a HWObject and adapt its length.
 
   Common::Logger::globalInfo(Common::Logger::L1,"addDpPa called for ", confPtr->getName().c_str());
-  Common::Logger::globalInfo(Common::Logger::L1,"addDpPa direction ", CharString(confPtr->getDirection()));
+  S7200_LOG_INFO(Common::Logger::L1, "addDpPa direction ", confPtr->getDirection());
 
   // tell the config how we will transform data to/from the device
   // by installing a Transformation object into the PeriphAddr
@@ -49,108 +44,36 @@ PVSSboolean S7200HWMapper::addDpPa(DpIdentifier &dpId, PeriphAddr *confPtr)
 
   std::vector<std::string> spltDol = Common::Utils::split((confPtr->getName()).c_str());
 
-  if(spltDol.size() == 1) {
-    switch ((uint32_t)confPtr->getTransformationType()) {
-        case TransUndefinedType:
-            Common::Logger::globalInfo(Common::Logger::L1,"Undefined transformation" + CharString(confPtr->getTransformationType()));
-            return HWMapper::addDpPa(dpId, confPtr);
-        case S7200DrvBoolTransType:
-              Common::Logger::globalInfo(Common::Logger::L3,"Bool transformation");
-              confPtr->setTransform(new Transformations::S7200BoolTrans);
-              break;
-        case S7200DrvUint8TransType:
-            Common::Logger::globalInfo(Common::Logger::L3,"Uint8 transformation");
-            confPtr->setTransform(new Transformations::S7200Uint8Trans);
-            break;
-        case S7200DrvInt32TransType:
-            Common::Logger::globalInfo(Common::Logger::L3,"Int32 transformation");
-            confPtr->setTransform(new Transformations::S7200Int32Trans);
-            break;
-        case S7200DrvInt16TransType:
-            Common::Logger::globalInfo(Common::Logger::L3,"Int16 transformation");
-            confPtr->setTransform(new Transformations::S7200Int16Trans);
-            break;
-        case S7200DrvFloatTransType:
-            Common::Logger::globalInfo(Common::Logger::L3,"Float transformation");
-            confPtr->setTransform(new Transformations::S7200FloatTrans);
-            break;
-        case S7200DrvStringTransType:
-              Common::Logger::globalInfo(Common::Logger::L3,"String transformation");
-              confPtr->setTransform(new Transformations::S7200StringTrans);
-              break;
-        default:
-            Common::Logger::globalError("S7200HWMapper::addDpPa", CharString("Illegal transformation type ") + CharString((int) confPtr->getTransformationType()));
-            return HWMapper::addDpPa(dpId, confPtr);
-      }
+  Transformation *trans = NULL;
+
+  if(spltDol.size() == 1 || (!spltDol[1].empty() && spltDol[1][0] == '_')) { //Config and Special Addresses
+    if((uint32_t)confPtr->getTransformationType() == TransUndefinedType) {
+      S7200_LOG_INFO(Common::Logger::L1, "Undefined transformation", (int) confPtr->getTransformationType());
+      return HWMapper::addDpPa(dpId, confPtr);
+    }
+
+    trans = Transformations::S7200TransFactory::create(confPtr->getTransformationType());
+    if(trans == NULL) {
+      Common::Logger::globalError("S7200HWMapper::addDpPa", CharString("Illegal transformation type ") + CharString((int) confPtr->getTransformationType()));
+      return HWMapper::addDpPa(dpId, confPtr);
+    }
   } else {
-  std::string recvdAddress(spltDol[1]);
-
-  if(S7200LibFacade::S7200AddressIsValid(recvdAddress)) {
-    if(S7200LibFacade::S7200AddressGetAmount(recvdAddress) > 1) {
-      Common::Logger::globalInfo(Common::Logger::L3,"String transformation");
-      confPtr->setTransform(new Transformations::S7200StringTrans);
-    } else {
-      switch(S7200LibFacade::S7200AddressGetWordLen(recvdAddress)) {
-        case S7WLBit: 
-            Common::Logger::globalInfo(Common::Logger::L3,"Bool transformation");
-            confPtr->setTransform(new Transformations::S7200BoolTrans);
-            break;
-        case S7WLByte:
-            Common::Logger::globalInfo(Common::Logger::L3,"Uint8 transformation");
-            confPtr->setTransform(new Transformations::S7200Uint8Trans);
-            break;
-        case S7WLWord:
-            Common::Logger::globalInfo(Common::Logger::L3,"Int16 transformation");
-            confPtr->setTransform(new Transformations::S7200Int16Trans);
-            break;
-        case S7WLReal:  
-            Common::Logger::globalInfo(Common::Logger::L3,"Float transformation");
-            confPtr->setTransform(new Transformations::S7200FloatTrans);
-            break;
-        default :
-            Common::Logger::globalError("S7200HWMapper::addDpPa",CharString("Illegal (Unexpected) address : ") +  CharString(confPtr->getName()));
-            return HWMapper::addDpPa(dpId, confPtr);
-      }
+    S7200Lane lane;
+    if(spltDol.size() == 4 && !S7200PollAddress::parseLane(spltDol[3], lane)) {
+      Common::Logger::globalError("S7200HWMapper::addDpPa",CharString("Illegal lane (critical, normal or bulk) : ") +  CharString(confPtr->getName()));
+      return HWMapper::addDpPa(dpId, confPtr);
     }
-  } else if(recvdAddress[0] == '_') { //Special Addresses
-      switch ((uint32_t)confPtr->getTransformationType()) {
-        case TransUndefinedType:
-            Common::Logger::globalInfo(Common::Logger::L1,"Undefined transformation" + CharString(confPtr->getTransformationType()));
-            return HWMapper::addDpPa(dpId, confPtr);
-        case S7200DrvBoolTransType:
-              Common::Logger::globalInfo(Common::Logger::L3,"Bool transformation");
-              confPtr->setTransform(new Transformations::S7200BoolTrans);
-              break;
-        case S7200DrvUint8TransType:
-            Common::Logger::globalInfo(Common::Logger::L3,"Uint8 transformation");
-            confPtr->setTransform(new Transformations::S7200Uint8Trans);
-            break;
-        case S7200DrvInt32TransType:
-            Common::Logger::globalInfo(Common::Logger::L3,"Int32 transformation");
-            confPtr->setTransform(new Transformations::S7200Int32Trans);
-            break;
-        case S7200DrvInt16TransType:
-            Common::Logger::globalInfo(Common::Logger::L3,"Int16 transformation");
-            confPtr->setTransform(new Transformations::S7200Int16Trans);
-            break;
-        case S7200DrvFloatTransType:
-            Common::Logger::globalInfo(Common::Logger::L3,"Float transformation");
-            confPtr->setTransform(new Transformations::S7200FloatTrans);
-            break;
-        case S7200DrvStringTransType:
-              Common::Logger::globalInfo(Common::Logger::L3,"String transformation");
-              confPtr->setTransform(new Transformations::S7200StringTrans);
-              break;
-        default:
-            Common::Logger::globalError("S7200HWMapper::addDpPa", CharString("Illegal transformation type ") + CharString((int) confPtr->getTransformationType()));
-            return HWMapper::addDpPa(dpId, confPtr);
-      }
-    } else {
+
+    trans = Transformations::S7200TransFactory::createForAddress(spltDol[1], confPtr->getTransformationType());
+    if(trans == NULL) {
       Common::Logger::globalError("S7200HWMapper::addDpPa",CharString("Illegal (Unexpected) address : ") +  CharString(confPtr->getName()));
       return HWMapper::addDpPa(dpId, confPtr);
     }
   }
 
+  S7200_LOG_INFO(Common::Logger::L3, "Transformation type ", (int) trans->isA());
+  confPtr->setTransform(trans);
+
   // First add the config, then the HW-Object
   if ( !HWMapper::addDpPa(dpId, confPtr) )  // FAILED !! 
   {
@@ -164,14 +87,14 @@ PVSSboolean S7200HWMapper::addDpPa(DpIdentifier &dpId, PeriphAddr *confPtr)
    //Common::Logger::globalInfo(Common::Logger::L3, CharString("Inserting counter value 1 for hardware object with address: ") + (addressOptions[0] + addressOptions[1]).c_str());
     addressCounter.insert(std::pair<std::string, int>(addressOptions[0] + addressOptions[1], 1));
   } else if (spltDol.size() > 1){
-    Common::Logger::globalInfo(Common::Logger::L3, CharString("Increasing counter value for hardware object with address: ") + (addressOptions[0] + addressOptions[1]).c_str());
+    S7200_LOG_INFO(Common::Logger::L3, "Increasing counter value for hardware object with address: ", addressOptions[0], addressOptions[1]);
     addressCounter[addressOptions[0] + addressOptions[1]]++; 
   }
 
   if(S7200Addresses.count(addressOptions[0])){
       for(auto it = S7200Addresses[addressOptions[0]].begin(); it!= S7200Addresses[addressOptions[0]].end(); it++ ) {
-        if(it->first == addressOptions[1]) {  
-          Common::Logger::globalInfo(Common::Logger::L3, CharString("Increased counter for duplicate hardware address: ") + confPtr->getName().c_str());
+        if(it->var == addressOptions[1]) {  
+          S7200_LOG_INFO(Common::Logger::L3, "Increased counter for duplicate hardware address: ", confPtr->getName());
           return PVSS_TRUE;
         }
       }
@@ -179,7 +102,7 @@ PVSSboolean S7200HWMapper::addDpPa(DpIdentifier &dpId, PeriphAddr *confPtr)
 
   HWObject *hwObj = new HWObject;
   // Set Address and Subindex
-  Common::Logger::globalInfo(Common::Logger::L3, "New Object", "name:" + confPtr->getName());
+  S7200_LOG_INFO(Common::Logger::L3, "New Object name:", confPtr->getName());
   hwObj->setConnectionId(confPtr->getConnectionId());
   hwObj->setAddress(confPtr->getName());       // Resolve the HW-Address, too
 
@@ -188,17 +111,18 @@ PVSSboolean S7200HWMapper::addDpPa(DpIdentifier &dpId, PeriphAddr *confPtr)
 
   // Set the len needed for data from _all_ subindices of this PVSS-Address.
   // Because we will deal with subix 0 only this is the Transformation::itemSize
+  // Array addresses (e.g. VW200[64]) are one item: the array transformation size covers
+  // all the elements and the whole block is delivered to the dyn DPE as one DynVar
   hwObj->setDlen(confPtr->getTransform()->itemSize());
-//TODO - number of elements?
   // Add it to the list
   addHWObject(hwObj);
 
   if(confPtr->getDirection() == DIRECTION_IN || confPtr->getDirection() == DIRECTION_INOUT)
   {
-      if (addressOptions.size() == 3) // IP + VAR + POLLTIME
+      if (addressOptions.size() == 3 || addressOptions.size() == 4) // IP + VAR + POLLTIME [+ LANE]
       {
         if(addressOptions[0].compare("VERSION"))
-          addAddress(addressOptions[0], addressOptions[1], addressOptions[2]);
+          addAddress(addressOptions[0], addressOptions[1], addressOptions[2], addressOptions.size() == 4 ? addressOptions[3] : "");
       }
   }
 
@@ -208,7 +132,7 @@ PVSSboolean S7200HWMapper::addDpPa(DpIdentifier &dpId, PeriphAddr *confPtr)
 
 PVSSboolean S7200HWMapper::clrDpPa(DpIdentifier &dpId, PeriphAddr *confPtr)
 {
-  Common::Logger::globalInfo(Common::Logger::L3, "clrDpPa called for" + confPtr->getName());
+  S7200_LOG_INFO(Common::Logger::L3, "clrDpPa called for ", confPtr->getName());
 
   std::vector<std::string> addressOptions = Common::Utils::split(confPtr->getName().c_str());
 
@@ -220,7 +144,7 @@ PVSSboolean S7200HWMapper::clrDpPa(DpIdentifier &dpId, PeriphAddr *confPtr)
   }
 
   if(addressOptions.size() > 1 && addressCounter[addressOptions[0] + addressOptions[1]]) {
-    Common::Logger::globalInfo(Common::Logger::L3, __PRETTY_FUNCTION__, "Decreased HW address counter for" + confPtr->getName());
+    S7200_LOG_INFO(Common::Logger::L3, __PRETTY_FUNCTION__, " Decreased HW address counter for ", confPtr->getName());
     return HWMapper::clrDpPa(dpId, confPtr);
   }
 
@@ -239,9 +163,9 @@ PVSSboolean S7200HWMapper::clrDpPa(DpIdentifier &dpId, PeriphAddr *confPtr)
 
   if(confPtr->getDirection() == DIRECTION_IN || confPtr->getDirection() == DIRECTION_INOUT)
   {
-      if (addressOptions.size() == 3) // IP + VAR + POLLTIME
+      if (addressOptions.size() == 3 || addressOptions.size() == 4) // IP + VAR + POLLTIME [+ LANE]
       {
-        removeAddress(addressOptions[0], addressOptions[1], addressOptions[2]);
+        removeAddress(addressOptions[0], addressOptions[1], addressOptions[2], addressOptions.size() == 4 ? addressOptions[3] : "");
       }
   }
 
@@ -253,57 +177,70 @@ PVSSboolean S7200HWMapper::clrDpPa(DpIdentifier &dpId, PeriphAddr *confPtr)
   }
 
   if(addressOptions.size() > 1) {
-    Common::Logger::globalInfo(Common::Logger::L3, __PRETTY_FUNCTION__, "Deleted entry in HW address counter for address : " + confPtr->getName());
+    S7200_LOG_INFO(Common::Logger::L3, __PRETTY_FUNCTION__, " Deleted entry in HW address counter for address : ", confPtr->getName());
     addressCounter.erase(addressCounter.find(addressOptions[0] + addressOptions[1]));
   }
   // Call function of base class to remove config
   return HWMapper::clrDpPa(dpId, confPtr);
 }
 
-void S7200HWMapper::addAddress(const std::string &ip, const std::string &var, const std::string &pollTime)
+void S7200HWMapper::addAddress(const std::string &ip, const std::string &var, const std::string &pollTime, const std::string &lane)
 {  
   if(S7200IPs.find(ip) == S7200IPs.end())
     {
         S7200IPs.insert(ip);
-        isIPrunning.insert(std::pair<std::string, bool>(ip, true));
         Common::Logger::globalInfo(Common::Logger::L1, "Received var from a new IP Address");
         S7200Addresses.erase(ip);
-        S7200Addresses.insert(std::pair<std::string, std::vector<std::pair<std::string, int>>>(ip, std::vector<std::pair<std::string, int>>()));
+        S7200Addresses.insert(std::pair<std::string, std::vector<S7200PollAddress>>(ip, std::vector<S7200PollAddress>()));
+        pushEvent(PlcEvent::PlcAdded, ip);
     }
 
     if(S7200Addresses.count(ip)){
-      if(std::find(S7200Addresses[ip].begin(), S7200Addresses[ip].end(), make_pair(var,  std::stoi(pollTime))) == S7200Addresses[ip].end())
+      S7200PollAddress address(var, pollTime, lane);
+      if(std::find(S7200Addresses[ip].begin(), S7200Addresses[ip].end(), address) == S7200Addresses[ip].end())
       {
-        S7200Addresses[ip].push_back(make_pair(var, std::stoi(pollTime)));
+        S7200Addresses[ip].push_back(address);
+        pushEvent(PlcEvent::AddressAdded, ip, address);
         Common::Logger::globalInfo(Common::Logger::L2, "Added to S7200AddressList", var.c_str());
       }
     }
 }
 
-void S7200HWMapper::removeAddress(const std::string &ip, const std::string &var, const std::string &pollTime)
+void S7200HWMapper::removeAddress(const std::string &ip, const std::string &var, const std::string &pollTime, const std::string &lane)
 { 
   if(S7200Addresses.count(ip)) {
-    
-    if(std::find(S7200Addresses[ip].begin(), S7200Addresses[ip].end(), make_pair(var,  std::stoi(pollTime))) != S7200Addresses[ip].end()) {
-        S7200Addresses[ip].erase(std::find(S7200Addresses[ip].begin(), S7200Addresses[ip].end(), make_pair(var,  std::stoi(pollTime))));
-        Common::Logger::globalInfo(Common::Logger::L3, __PRETTY_FUNCTION__,  CharString("Erased address: ") + var.c_str() + CharString("With polling time: ") + pollTime.c_str() + CharString(" On IP: ")+ ip.c_str());
+    S7200PollAddress address(var, pollTime, lane);
+
+    if(std::find(S7200Addresses[ip].begin(), S7200Addresses[ip].end(), address) != S7200Addresses[ip].end()) {
+        S7200Addresses[ip].erase(std::find(S7200Addresses[ip].begin(), S7200Addresses[ip].end(), address));
+        pushEvent(PlcEvent::AddressRemoved, ip, address);
+        S7200_LOG_INFO(Common::Logger::L3, __PRETTY_FUNCTION__, " Erased address: ", var, " With polling time: ", pollTime, " On IP: ", ip);
     }
 
     if(S7200Addresses[ip].size() == 0) {
       S7200IPs.erase(ip);
       S7200Addresses.erase(ip);
       Common::Logger::globalInfo(Common::Logger::L1, __PRETTY_FUNCTION__,  "All Addresses deleted from the IP : ", ip.c_str());
-
-      while(isIPrunning[ip])
-      {
-          Common::Logger::globalInfo(Common::Logger::L1, __PRETTY_FUNCTION__, " Sleeping for 1 second since the Polling is still running for the IP : ", ip.c_str());
-          std::this_thread::sleep_for(std::chrono::seconds(1));
-      }
-      Common::Logger::globalInfo(Common::Logger::L1, __PRETTY_FUNCTION__,"Ready to register new device as Lambda Thread exited from the polling loop for the IP : ", ip.c_str());
+      // the session of this IP is stopped and released by the next workProc
+      pushEvent(PlcEvent::PlcRemoved, ip);
     }
   }
 }
 
 bool S7200HWMapper::checkIPExist(std::string ip) {
   return S7200IPs.count(ip);
+}
+
+void S7200HWMapper::pushEvent(PlcEvent::Kind kind, const std::string& ip, const S7200PollAddress& address)
+{
+  std::lock_guard<std::mutex> lock{_eventMutex};
+  _events.push_back(PlcEvent{kind, ip, address});
+}
+
+std::vector<S7200HWMapper::PlcEvent> S7200HWMapper::takeEvents()
+{
+  std::vector<PlcEvent> events;
+  std::lock_guard<std::mutex> lock{_eventMutex};
+  events.swap(_events);
+  return events;
 }
\ No newline at end of file
@@ -18,33 +18,52 @@
 
 #include <HWMapper.hxx>
 #include <unordered_set>
+#include <mutex>
+#include "S7200PollAddress.hxx"
 
-// TODO: Write here all the Transformation types, one for every transformation
+// Write here all the Transformation types, one for every transformation (see Transformations/S7200TransFactory.cxx)
 #define S7200DrvBoolTransType (TransUserType)
 #define S7200DrvUint8TransType (TransUserType + 1)
 #define S7200DrvInt16TransType (TransUserType + 2)
 #define S7200DrvInt32TransType (TransUserType + 3)
 #define S7200DrvFloatTransType (TransUserType + 4)
 #define S7200DrvStringTransType (TransUserType + 5)
+#define S7200DrvUint16TransType (TransUserType + 6)
+#define S7200DrvUint32TransType (TransUserType + 7)
+#define S7200DrvDoubleTransType (TransUserType + 8)
 
 class S7200HWMapper : public HWMapper
 {
   public:
-    std::map<std::string, bool> isIPrunning;
     virtual PVSSboolean addDpPa(DpIdentifier &dpId, PeriphAddr *confPtr);
     virtual PVSSboolean clrDpPa(DpIdentifier &dpId, PeriphAddr *confPtr);
 
     const std::unordered_set<std::string>& getS7200IPs() {return S7200IPs;}
-    const std::map<std::string, std::vector<std::pair<std::string, int>>>& getS7200Addresses(){return S7200Addresses;}
+    const std::map<std::string, std::vector<S7200PollAddress>>& getS7200Addresses(){return S7200Addresses;}
     bool checkIPExist(std::string);
 
+    // A PLC got its first address or lost its last one, or one of its polled addresses was added or removed
+    struct PlcEvent
+    {
+        enum Kind {PlcAdded, PlcRemoved, AddressAdded, AddressRemoved};
+        Kind kind;
+        std::string ip;
+        S7200PollAddress address; // AddressAdded and AddressRemoved only
+    };
+    // The events since the last call, in order
+    std::vector<PlcEvent> takeEvents();
+
   private:
-    void addAddress(const std::string &ip, const std::string &var, const std::string &pollTime);
-    void removeAddress(const std::string& ip, const std::string& var, const std::string &pollTime);
+    void addAddress(const std::string &ip, const std::string &var, const std::string &pollTime, const std::string &lane);
+    void removeAddress(const std::string& ip, const std::string& var, const std::string &pollTime, const std::string &lane);
 
     std::unordered_set<std::string> S7200IPs;
     std::map<std::string,  int> addressCounter; //For counting the number of times an address has been added
-    std::map<std::string, std::vector<std::pair<std::string, int>>> S7200Addresses;
+    std::map<std::string, std::vector<S7200PollAddress>> S7200Addresses;
+
+    std::mutex _eventMutex;
+    std::vector<PlcEvent> _events;
+    void pushEvent(PlcEvent::Kind kind, const std::string& ip, const S7200PollAddress& address = S7200PollAddress());
 
     enum Direction
     {
@@ -18,11 +18,16 @@
 #include <DrvManager.hxx>
 #include <PVSSMacros.hxx>     // DEBUG macros
 #include "Common/Logger.hxx"
+#include "Common/LogSink.hxx"
+#include "Common/ValueStore.hxx"
 #include "Common/Constants.hxx"
 #include "Common/Utils.hxx"
 
 #include "S7200HWMapper.hxx"
 #include "S7200LibFacade.hxx"
+#include "S7200PlcSession.hxx"
+#include "S7200Snapshot.hxx"
+#include "S7200Watchdog.hxx"
 
 #include <signal.h>
 #include <execinfo.h>
@@ -30,6 +35,9 @@
 #include <chrono>
 #include <utility>
 #include <thread>
+#include <condition_variable>
+#include <mutex>
+#include <algorithm>
 
 static std::atomic<bool> _consumerRun{true};
 
@@ -46,6 +54,18 @@ PVSSboolean S7200HWService::initialize(int argc, char *argv[])
   // use this function to initialize internals
   // if you don't need it, you can safely remove the whole method
   Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__,"start");
+  // info and warning messages are delivered by a background thread from now on
+  Common::LogSink::getInstance().start();
+
+  // last raw values shared with the local tools, in <project>/data/
+  if(Common::Constants::getValueStoreSlots() > 0)
+    Common::ValueStore::getInstance().open(std::string(S7200Resources::getDataDir().c_str()) + Common::Constants::getDrvName() + "_" +
+                                           std::to_string(Common::Constants::getDrvNo()) + ".values", Common::Constants::getValueStoreSlots());
+
+  // values of the previous run, for a warm start
+  if(Common::Constants::getSnapshotInterval() > 0)
+    S7200Snapshot::getInstance().open(std::string(S7200Resources::getDataDir().c_str()) + Common::Constants::getDrvName() + "_" +
+                                      std::to_string(Common::Constants::getDrvNo()) + ".snapshot", Common::Constants::getSnapshotInterval());
   // To stop driver return PVSS_FALSE
   return PVSS_TRUE;
 }
@@ -60,26 +80,34 @@ void S7200HWService::handleConsumeNewMessage(const std::string& ip, const std::s
   if(ip.compare("_VERSION") == 0)  {
     insertInDataToDp(std::move(CharString((ip).c_str())), payload);  //Config DPs do not have a polling time or an IP address associated with them in the address.
   }
-  else if(var.compare("_Error") == 0)
-    insertInDataToDp(std::move(CharString((ip + "$" + var ).c_str())), payload);  //Config DPs do not have a polling time associated with them in the address.
+  else if(!var.empty() && var[0] == '_')
+    insertInDataToDp(std::move(CharString((ip + "$" + var ).c_str())), payload);  //Status DPs (_Error, _PollRate) do not have a polling time associated with them in the address.
   else 
     //Common::Logger::globalInfo(Common::Logger::L3, __PRETTY_FUNCTION__, (ip + ":" + var + ":" + payload).c_str());
-    insertInDataToDp(std::move(CharString((ip + "$" + var + "$" + pollTime).c_str())), payload);
+    insertInDataToDp(std::move(CharString((ip + "$" + var + "$" + pollTime).c_str())), payload);  //pollTime holds the lane too when the address has one
 }
 
 void S7200HWService::handleNewIPAddress(const std::string& ip)
 { 
+    // the session owns the facade, the write queue and the polling thread
+    auto session = std::make_shared<S7200PlcSession>(ip, Common::ConnectionSettings::compile(ip), this->_configConsumeCB, this->_configErrorConsumerCB,
+                                                     this->_batchConsumeCB);
+    // the addresses known so far, then the address events of the mapper (workProc)
+    const auto& addresses = static_cast<S7200HWMapper*>(DrvManager::getHWMapperPtr())->getS7200Addresses();
+    auto known = addresses.find(ip);
+    if(known != addresses.end())
+      session->setAddresses(known->second);
+    if(!_sessions.add(session)) {
+        Common::Logger::globalWarning(__PRETTY_FUNCTION__, "The PLC already has a session, not polled again:", ip.c_str());
+        return;
+    }
     Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, "New IP:", ip.c_str());
-    static_cast<S7200HWMapper*>(DrvManager::getHWMapperPtr())->isIPrunning.insert(std::pair<std::string, bool>(ip, true));
-    static_cast<S7200HWMapper*>(DrvManager::getHWMapperPtr())->isIPrunning[ip] = true;
 
-    auto lambda = [&]
+    auto lambda = [this, session]
         {
-          std::string IP_FIXED = ip.c_str();
+          const std::string& IP_FIXED = session->getIp();
           Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, "Inside polling thread");
-          S7200LibFacade aFacade(ip, this->_configConsumeCB, this->_configErrorConsumerCB);
-          _facades[ip] = &aFacade;
-          writeQueueForIP.insert(std::pair < std::string, std::vector < std::pair < std::string, void * > > > ( ip, std::vector<std::pair<std::string, void *> > ()));
+          S7200LibFacade& aFacade = session->getFacade();
           aFacade.Connect();
 
           if(!aFacade.isInitialized())
@@ -87,7 +115,7 @@ void S7200HWService::handleNewIPAddress(const std::string& ip)
               Common::Logger::globalInfo(Common::Logger::L1, "Unable to initialize IP:", IP_FIXED.c_str());
               Common::Logger::globalInfo(Common::Logger::L1, "Trying to connect again in 5 seconds");
               
-              std::this_thread::sleep_for(std::chrono::seconds(5));
+              session->wait(std::chrono::seconds(5));
 
               aFacade.S7200MarkDeviceConnectionError(IP_FIXED, true);
               
@@ -98,46 +126,56 @@ void S7200HWService::handleNewIPAddress(const std::string& ip)
                 if(!aFacade.isInitialized()) {
                   Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, "Failure in re-connection. Trying again in 5 seconds");
                   aFacade.Disconnect();
-                  std::this_thread::sleep_for(std::chrono::seconds(5));
+                  session->wait(std::chrono::seconds(5));
                 }
-              } while(!aFacade.isInitialized()  && static_cast<S7200HWMapper*>(DrvManager::getHWMapperPtr())->checkIPExist(IP_FIXED) &&_consumerRun);
+              } while(!aFacade.isInitialized()  && session->isRunning());
           }
 
-          if(aFacade.isInitialized() && static_cast<S7200HWMapper*>(DrvManager::getHWMapperPtr())->checkIPExist(IP_FIXED) && _consumerRun) {
-            std::this_thread::sleep_for(std::chrono::seconds(3)); //Give some time for the driver to load the addresses.
+          if(aFacade.isInitialized() && session->isRunning()) {
+            session->wait(std::chrono::seconds(3)); //Give some time for the driver to load the addresses.
 
             aFacade.S7200MarkDeviceConnectionError(IP_FIXED, false);
 
             auto first_time = std::chrono::steady_clock::now();
+            // swapped with the write queue of the session at every cycle
+            S7200WriteBuffer writes;
+            // copied again only when the address events of the mapper change them
+            std::vector<S7200PollAddress> addresses;
+            unsigned addressGeneration = 0;
             
-            while(_consumerRun && static_cast<S7200HWMapper*>(DrvManager::getHWMapperPtr())->checkIPExist(IP_FIXED))
+            while(session->isRunning())
             {
-              if(!S7200Resources::getDisableCommands()) {
-                // The Server is Active (for redundant systems)
-                
-                Common::Logger::globalInfo(Common::Logger::L2,__PRETTY_FUNCTION__, "Polling");
-                auto cycleInterval = std::chrono::seconds(1);
+              // The Server is Passive (for redundant systems): in hot standby it keeps polling at a reduced rate
+              // to keep the connection and the last-value cache warm, the values are not forwarded to WinCC OA
+              bool passive = S7200Resources::getDisableCommands();
+              size_t standbyInterval = Common::Constants::getStandbyPollingInterval();
+
+              if(!passive || standbyInterval > 0) {
+                S7200_LOG_INFO(Common::Logger::L2, __PRETTY_FUNCTION__, passive ? " Standby polling" : " Polling");
+                auto cycleInterval = passive ? std::chrono::seconds(standbyInterval) : std::chrono::seconds(1);
                 auto start = std::chrono::steady_clock::now();
 
-                auto vars = static_cast<S7200HWMapper*>(DrvManager::getHWMapperPtr())->getS7200Addresses();
-                if(vars.find(IP_FIXED) != vars.end()){
-                    //First do all the writes for this IP, then the reads
-                    aFacade.write(writeQueueForIP[IP_FIXED]);
-                    aFacade.markForNextRead(writeQueueForIP[IP_FIXED], first_time);
-                    writeQueueForIP[IP_FIXED].clear();
-                    aFacade.Poll(vars[IP_FIXED], start);                         
+                if(session->takeAddresses(addresses, addressGeneration))
+                    aFacade.setAddresses(std::move(addresses));
+                if(aFacade.hasAddresses()){
+                    //First do all the writes for this IP, then the reads. The passive node never writes.
+                    if(!passive) {
+                      session->takeWrites(writes);
+                      aFacade.markForNextRead(writes, first_time);
+                      aFacade.write(writes);
+                    }
+                    aFacade.Poll(start);
                 }
-                auto end = std::chrono::steady_clock::now();
-                auto time_elapsed = end - start;
-                
-                // If we still have time left, then sleep
-                if(time_elapsed < cycleInterval)
-                  std::this_thread::sleep_for(cycleInterval- time_elapsed);
 
-                if(aFacade.readFailures > 5) {
-                  Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, "More than 5 read failures, Disconnecting");
+                // If we still have time left, then sleep. Stop sleeping as soon as the redundancy state changes.
+                while(std::chrono::steady_clock::now() - start < cycleInterval && passive == S7200Resources::getDisableCommands() && session->isRunning())
+                  session->wait(std::min<std::chrono::steady_clock::duration>(cycleInterval - (std::chrono::steady_clock::now() - start), std::chrono::milliseconds(100)));
+
+                if(aFacade.needsReconnect()) {
+                  Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, "Link lost or more than 5 read failures, Disconnecting");
 
                   aFacade.S7200MarkDeviceConnectionError(IP_FIXED, true);
+                  aFacade.invalidateValues();
 
                   do {
                     //Disconnect and try to connect again.
@@ -146,34 +184,34 @@ void S7200HWService::handleNewIPAddress(const std::string& ip)
 
                     if(!aFacade.isInitialized()) {
                       Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, "Failure in re-connection. Trying again in 5 seconds");
-                      std::this_thread::sleep_for(std::chrono::seconds(5));
+                      session->wait(std::chrono::seconds(5));
                     }
-                  } while(!aFacade.isInitialized() && static_cast<S7200HWMapper*>(DrvManager::getHWMapperPtr())->checkIPExist(IP_FIXED) && _consumerRun);
+                  } while(!aFacade.isInitialized() && session->isRunning());
                   aFacade.readFailures = 0;
                   aFacade.S7200MarkDeviceConnectionError(IP_FIXED, false);
                 }
               } else {
                 // The Server is Passive (for redundant systems)
-                std::this_thread::sleep_for(std::chrono::seconds(1));
+                session->wait(std::chrono::seconds(1));
               }
             }
           }
 
-          if( static_cast<S7200HWMapper*>(DrvManager::getHWMapperPtr())->checkIPExist(IP_FIXED) == false )
-            Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, "Out of polling loop for the thread. IP removed from list. IP: ", IP_FIXED.c_str());
-          else if(!_consumerRun)
+          if(!_consumerRun)
             Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, "Out of polling loop for the thread. All threads were asked to stop. This looping thread was for IP: ", IP_FIXED.c_str()); 
           else
-            Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, "Out of polling loop for the thread. A different reason. This looping thread was for IP: ", IP_FIXED.c_str()); 
+            Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, "Out of polling loop for the thread. IP removed from list. IP: ", IP_FIXED.c_str());
 
+          if(!_consumerRun)
+            aFacade.saveSnapshot();
           aFacade.Disconnect();
-          IPAddressList.erase(IP_FIXED);
-          static_cast<S7200HWMapper*>(DrvManager::getHWMapperPtr())->isIPrunning[IP_FIXED] = false;
           aFacade.clearLastWriteTimeList();
 
           Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, "Exiting Lambda Thread. IP: ", IP_FIXED.c_str());
+          session->finish();
+          _sessions.notifyFinished();
         };    
-    _pollingThreads.emplace_back(lambda);
+    session->start(lambda);
 }
 
 //--------------------------------------------------------------------------------
@@ -182,12 +220,22 @@ void S7200HWService::handleNewIPAddress(const std::string& ip)
 PVSSboolean S7200HWService::start()
 {
   // use this function to start your hardware activity.  
+  {
+    std::lock_guard<std::mutex> lock{_toDPmutex};
+    _passive = S7200Resources::getDisableCommands();
+  }
+
+  // Watchdog of the snap7 calls: a stuck call gets its connection closed
+  S7200Watchdog::getInstance().start();
+
+   // the snapshot keeps only the values of the addresses configured now
+   S7200Snapshot::getInstance().prune(static_cast<S7200HWMapper*>(DrvManager::getHWMapperPtr())->getS7200Addresses());
+
    // Check if we need to launch consumer(s)
    // This list is automatically built by exisiting addresses sent at driver startup
    // new top
    for (const auto& ip : static_cast<S7200HWMapper*>(DrvManager::getHWMapperPtr())->getS7200IPs() )
    {
-        IPAddressList.insert(ip);
         this->handleNewIPAddress(ip);
    }
 
@@ -202,7 +250,7 @@ PVSSboolean S7200HWService::start()
 
 int S7200HWService::CheckIP(std::string IPAddress)
 {
-  return IPAddressList.count(IPAddress);
+  return _sessions.find(IPAddress) ? 1 : 0;
 }
 //--------------------------------------------------------------------------------
 
@@ -210,47 +258,107 @@ void S7200HWService::stop()
 {
   // use this function to stop your hardware activity.
   Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__,"Stop");
+  auto stopStart = std::chrono::steady_clock::now();
   _consumerRun = false;
 
-  for(auto& pt : _pollingThreads)
-  {
-    if(pt.joinable())
-        pt.join();
-  }
+  // wake up the waiting threads, the busy ones stop after their current snap7 request
+  S7200LibFacade::cancelAll(true);
+  _sessions.stopAll();
+  S7200Watchdog::getInstance().stop();
+  S7200_LOG_INFO(Common::Logger::L1, __PRETTY_FUNCTION__, " Polling threads stopped in ",
+                 std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - stopStart).count(), " ms");
+  Common::ValueStore::getInstance().close();
+  S7200Snapshot::getInstance().save();
+
+  // flush the messages queued by the polling threads
+  Common::LogSink::getInstance().stop();
 }
 
 //--------------------------------------------------------------------------------
 
 void S7200HWService::workProc()
 {
-  for (const auto& ip : static_cast<S7200HWMapper*>(DrvManager::getHWMapperPtr())->getS7200IPs() )
+  // PLCs and addresses added or removed by the address configuration: the sessions of the removed PLCs stop,
+  // the running ones get their address changes (a new session takes the addresses of the mapper)
+  for (const auto& event : static_cast<S7200HWMapper*>(DrvManager::getHWMapperPtr())->takeEvents())
+  {
+        if(event.kind == S7200HWMapper::PlcEvent::PlcAdded) {
+          _pendingIPs.insert(event.ip);
+          continue;
+        }
+        if(event.kind == S7200HWMapper::PlcEvent::PlcRemoved)
+          _pendingIPs.erase(event.ip);
+
+        std::shared_ptr<S7200PlcSession> session = _sessions.find(event.ip);
+        if(!session || !session->isRunning())
+          continue;
+        if(event.kind == S7200HWMapper::PlcEvent::PlcRemoved)
+          session->stop();
+        else if(event.kind == S7200HWMapper::PlcEvent::AddressAdded)
+          session->addAddress(event.address);
+        else
+          session->removeAddress(event.address);
+  }
+  _sessions.reap();
+
+  // A PLC added again while its previous session is still stopping waits for it to be released
+  for (auto ip = _pendingIPs.begin(); ip != _pendingIPs.end() && _consumerRun; )
    {
-        if(IPAddressList.count(ip) == 0)
-        {
+        std::shared_ptr<S7200PlcSession> session = _sessions.find(*ip);
+        if(session && !session->isRunning()) {
+          ++ip;
+          continue;
+        }
+        if(!session) {
           Common::Logger::globalInfo(Common::Logger::L1,"Calling HandleNewIP() from workProc()");
-          IPAddressList.insert(ip);
-          this->handleNewIPAddress(ip);
+          this->handleNewIPAddress(*ip);
         }
+        ip = _pendingIPs.erase(ip);
    }
 
   HWObject obj;
   //Common::Logger::globalInfo(Common::Logger::L1,"Inside WorkProc");
   // TODO somehow receive a message from your device
   std::lock_guard<std::mutex> lock{_toDPmutex};
+
+  // Redundancy switchover: the values polled while passive are sent right away
+  bool passive = S7200Resources::getDisableCommands();
+  if(_passive && !passive) {
+    S7200_LOG_INFO(Common::Logger::L1, __PRETTY_FUNCTION__, " Switched to active, flushing standby cache of size ", _standbyCache.size());
+    for(auto& cached : _standbyCache)
+      _toDPqueue.push(ToDp(CharString(cached.first.c_str()), cached.second.value, cached.second.time));
+    _standbyCache.clear();
+  }
+  _passive = passive;
   //Common::Logger::globalInfo(Common::Logger::L1,"Get lock on DPmutex");
   //Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__,"Size", CharString(_toDPqueue.size()));
-  while (!_toDPqueue.empty())
+  // Bounded number of values per call so that the manager stays responsive, the rest goes with the next call
+  size_t budget = Common::Constants::getWorkProcBudget();
+  size_t sent = 0;
+  while (!_toDPqueue.empty() && (budget == 0 || sent++ < budget))
   {
     //Common::Logger::globalInfo(Common::Logger::L3,__PRETTY_FUNCTION__, CharString("There are ") + (to_string((_toDPqueue.size()))).c_str() + CharString(" elements to process"));
-    auto pair = std::move(_toDPqueue.front());
+    ToDp item = std::move(_toDPqueue.front());
     _toDPqueue.pop();
     //        Common::Logger::globalInfo(Common::Logger::L1,"For Request, First element is ", pair.first);
     //    Common::Logger::globalInfo(Common::Logger::L1,"For Request, Second element is ", pair.second);
-    std::vector<std::string> addressOptions = Common::Utils::split(pair.first.c_str());
-    obj.setAddress(pair.first);
+    if(item.batch.empty()) {
+      sendToDp(obj, item.address, item.value, false, item.time);
+    } else {
+      // all the values of a PLC invalidated or valid again together
+      for(auto& value : item.batch)
+        sendToDp(obj, value.first, value.second, item.invalid, item.time);
+    }
+  }
+}
 
-    if(strcmp(pair.first.c_str(), "_VERSION") == 0) {
-        Common::Logger::globalInfo(Common::Logger::L2,"For driver version, writing to WinCCOA value ", pair.second);
+void S7200HWService::sendToDp(HWObject& obj, const CharString& address, char* value, bool invalid, const TimeVar& time)
+{
+    std::vector<std::string> addressOptions = Common::Utils::split(address.c_str());
+    obj.setAddress(address);
+
+    if(strcmp(address.c_str(), "_VERSION") == 0) {
+        Common::Logger::globalInfo(Common::Logger::L2,"For driver version, writing to WinCCOA value ", value);
     }
 
 //    // a chance to see what's happening
@@ -263,40 +371,86 @@ void S7200HWService::workProc()
     // ok, we found it; now send to the DPEs
     if ( addrObj )
     {
-        //Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, pair.first, pair.second);
+        //Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, address, value);
         //addrObj->debugPrint();
-        obj.setOrgTime(TimeVar());  // current time
+        obj.setOrgTime(time);  // time of the read
         
-        if(strcmp(pair.first.c_str(), "_VERSION") == 0) {
+        if(strcmp(address.c_str(), "_VERSION") == 0) {
           obj.setDlen(4);
-          Common::Logger::globalInfo(Common::Logger::L2,"AddrObj found, For driver version, writing to WinCCOA value ", pair.second);
+          Common::Logger::globalInfo(Common::Logger::L2,"AddrObj found, For driver version, writing to WinCCOA value ", value);
+        } else if(addressOptions.size() > 1 && !addressOptions[1].empty() && addressOptions[1][0] == '_') {
+          // Status DPs: the size is the one of their transformation
+          obj.setDlen(addrObj->getDlen());
         } else {
-          int dataLengh = S7200LibFacade::getByteSizeFromAddress(Common::Utils::split(pair.first.c_str())[1]);
+          int dataLengh = S7200LibFacade::getByteSizeFromAddress(Common::Utils::split(address.c_str())[1]);
 
-          //   Common::Logger::globalInfo(Common::Logger::L1, "-->send to WinCCOA first ", pair.first.  c_str());
-          //   Common::Logger::globalInfo(Common::Logger::L1, "-->send to WinCCOA second ", pair.second );
+          //   Common::Logger::globalInfo(Common::Logger::L1, "-->send to WinCCOA first ", address.  c_str());
+          //   Common::Logger::globalInfo(Common::Logger::L1, "-->send to WinCCOA second ", value );
           //   Common::Logger::globalInfo(Common::Logger::L1, "-->send to WinCCOA thirds ", std::to_string(dataLengh).c_str());
           //Common::Logger::globalInfo(Common::Logger::L1,"Data length is ", std::to_string(dataLengh).c_str());
           obj.setDlen(dataLengh); // lengh
         }
 
-        obj.setData((PVSSchar*)pair.second); //data
+        obj.setData((PVSSchar*)value); //data
         obj.setObjSrcType(srcPolled);
+        if(invalid)
+          obj.setSbit(DRV_INVALID);
+        else
+          obj.clrSbit(DRV_INVALID);
 
         if( DrvManager::getSelfPtr()->toDp(&obj, addrObj) != PVSS_TRUE) {
           Common::Logger::globalInfo(Common::Logger::L1,"Problem in sending item's value to PVSS");
         }
     } else {
-        Common::Logger::globalInfo(Common::Logger::L1,"Problem in getting HWObject for the address: " + pair.first);   
+        S7200_LOG_INFO(Common::Logger::L1, "Problem in getting HWObject for the address: ", address);
+        delete[] value;
     }
-  }
 }
 
 void S7200HWService::insertInDataToDp(CharString&& address, char* item)
 {
 
     std::lock_guard<std::mutex> lock{_toDPmutex};
-    _toDPqueue.push(std::move(std::make_pair<CharString, char*>(std::move(address), std::move(item))));
+    if(_passive && strcmp(address.c_str(), "_VERSION") != 0) {
+      // Passive node: only keep the last value of each address until the switchover
+      StandbyValue& cached = _standbyCache[std::string(address.c_str())];
+      delete[] cached.value;
+      cached.value = item;
+      cached.time = TimeVar();
+      return;
+    }
+    _toDPqueue.push(ToDp(std::move(address), item));
+}
+
+void S7200HWService::handleConsumeBatch(const std::string& ip, std::vector<S7200BatchValue>& values, bool invalid)
+{
+    std::lock_guard<std::mutex> lock{_toDPmutex};
+    if(_passive) {
+      // Passive node: values invalid until the switchover are not sent, the values valid again are cached as usual
+      for(auto& value : values) {
+        std::string address = ip + "$" + value.var + "$" + value.pollTime;
+        auto cached = _standbyCache.find(address);
+        if(cached != _standbyCache.end()) {
+          delete[] cached->second.value;
+          _standbyCache.erase(cached);
+        }
+        if(invalid)
+          delete[] value.payload;
+        else {
+          StandbyValue& cachedValue = _standbyCache[address];
+          cachedValue.value = value.payload;
+          cachedValue.time = TimeVar();
+        }
+      }
+      return;
+    }
+
+    ToDp item;
+    item.invalid = invalid;
+    item.batch.reserve(values.size());
+    for(auto& value : values)
+      item.batch.push_back(std::make_pair(CharString((ip + "$" + value.var + "$" + value.pollTime).c_str()), value.payload));
+    _toDPqueue.push(std::move(item));
 }
 
 //--------------------------------------------------------------------------------
@@ -314,24 +468,23 @@ PVSSboolean S7200HWService::writeData(HWObject *objPtr)
       {
         Common::Logger::globalInfo(Common::Logger::L1,"Incoming CONFIG address",objPtr->getAddress(), objPtr->getInfo() );
         
-        if(addressOptions[ADDRESS_OPTIONS_IP].compare("_DEBUGLVL") == 0) {
-          int16_t* retVal = new int16_t;
-          char *IntToConvert = ( char* )objPtr->getDataPtr();
-
-          // swap the bytes into a temporary buffer
-          retVal[0] = IntToConvert[1];
-          retVal[1] = IntToConvert[0];
-
-          Common::Logger::globalInfo(Common::Logger::L1,"Received DebugLvl change request to value: ", std::to_string(*retVal).c_str());
-
-          if(*retVal > 0 && *retVal  < 4) {
-              Common::Constants::GetParseMap().at(std::string(objPtr->getAddress().c_str()))((char *)retVal);
-              Common::Logger::globalInfo(Common::Logger::L1,"Set Debug level successfully to : ", std::to_string(*retVal).c_str());
-          } 
-          
-          delete retVal;
-          return PVSS_TRUE;
+        // Runtime settings (see Common::Constants::parse_map): the transformation gives a big endian integer
+        const auto& setting = Common::Constants::GetParseMap().at(addressOptions[ADDRESS_OPTIONS_IP]);
+        const PVSSchar* data = objPtr->getDataPtr();
+        PVSSuint dlen = objPtr->getDlen();
+        if(data == NULL || dlen == 0 || dlen > sizeof(int32_t)) {
+          Common::Logger::globalWarning(__PRETTY_FUNCTION__," Invalid value for configuration address:", objPtr->getAddress().c_str());
+          return PVSS_FALSE;
         }
+
+        uint32_t value = 0;
+        for(PVSSuint i = 0; i < dlen; i++)
+          value = (value << 8) | data[i];
+        // sign extension for 1 and 2 bytes integers
+        int32_t signedValue = dlen < sizeof(int32_t) && (data[0] & 0x80) ? (int32_t)(value | (~0u << (dlen * 8))) : (int32_t)value;
+
+        S7200_LOG_INFO(Common::Logger::L1, "Received ", addressOptions[ADDRESS_OPTIONS_IP], " change request to value: ", signedValue);
+        return setting(signedValue) ? PVSS_TRUE : PVSS_FALSE;
         
       }
       catch (std::exception& e)
@@ -339,7 +492,7 @@ PVSSboolean S7200HWService::writeData(HWObject *objPtr)
           Common::Logger::globalWarning(__PRETTY_FUNCTION__," No configuration handling for address:", objPtr->getAddress().c_str());
       }
   }
-  else if (addressOptions.size() == ADDRESS_OPTIONS_SIZE) // Output
+  else if (addressOptions.size() == ADDRESS_OPTIONS_SIZE || addressOptions.size() == ADDRESS_OPTIONS_LANE + 1) // Output
   {
 
     if(!addressOptions[ADDRESS_OPTIONS_IP].length())
@@ -348,57 +501,44 @@ PVSSboolean S7200HWService::writeData(HWObject *objPtr)
         return PVSS_FALSE;
     }
 
-    if(_facades.find(addressOptions[ADDRESS_OPTIONS_IP]) != _facades.end()){
+    std::shared_ptr<S7200PlcSession> session = _sessions.find(addressOptions[ADDRESS_OPTIONS_IP]);
+    if(session){
         if(!S7200LibFacade::S7200AddressIsValid(addressOptions[ADDRESS_OPTIONS_VAR])){
             Common::Logger::globalWarning("Not a valid Var for address", objPtr->getAddress().c_str());
             return PVSS_FALSE;
         }
         else{
-          auto wrQueue = writeQueueForIP.find(addressOptions[ADDRESS_OPTIONS_IP]);
-          int length = (int)objPtr->getDlen();
+          // The transformation encoded the value for the PLC, the session converts it if the address has another width
+          S7200WriteBuffer::Kind kind;
+          switch(objPtr->getType()) {
+            case S7200DrvInt16TransType:
+            case S7200DrvInt32TransType:
+              kind = S7200WriteBuffer::Kind::Signed;
+              break;
+            case S7200DrvBoolTransType:
+            case S7200DrvUint8TransType:
+            case S7200DrvUint16TransType:
+            case S7200DrvUint32TransType:
+              kind = S7200WriteBuffer::Kind::Unsigned;
+              break;
+            case S7200DrvFloatTransType:
+            case S7200DrvDoubleTransType:
+              kind = S7200WriteBuffer::Kind::Float;
+              break;
+            default:
+              kind = S7200WriteBuffer::Kind::Raw;
+              break;
+          }
 
-          if(length == 2) {
-            char *correctval = new char[sizeof(int16_t)];
-            std::memcpy(correctval, objPtr->getDataPtr(), sizeof(int16_t));
-            int16_t* checkVal = reinterpret_cast<int16_t*> (correctval);
+          // <IP>$<VAR>$<POLLTIME>$critical or <IP>$<VAR>$$critical: not held back by the write limiter
+          S7200Lane lane = S7200Lane::Normal;
+          if(addressOptions.size() > ADDRESS_OPTIONS_LANE)
+            S7200PollAddress::parseLane(addressOptions[ADDRESS_OPTIONS_LANE], lane);
 
-            const int16_t inInt16 = *checkVal;
-            
-              int16_t retVal;
-              char *IntToConvert = ( char* ) & inInt16;
-              char *returnInt = ( char* ) & retVal;
-
-              // swap the bytes into a temporary buffer
-              returnInt[0] = IntToConvert[1];
-              returnInt[1] = IntToConvert[0];
-
-            Common::Logger::globalInfo(Common::Logger::L2,"Received request to write integer, Correct val is: ", to_string(retVal).c_str());
-            wrQueue->second.push_back( std::make_pair( addressOptions[ADDRESS_OPTIONS_VAR], correctval));
-          } else if(length == 4){
-            char *correctval = new char[sizeof(float)];
-            std::memcpy(correctval, objPtr->getDataPtr(), sizeof(float));
-            float *checkVal = reinterpret_cast<float*> (correctval);
-
-            const float inFloat = *checkVal;
-           
-            float retVal;
-            char *floatToConvert = ( char* ) & inFloat;
-            char *returnFloat = ( char* ) & retVal;
-
-            // swap the bytes into a temporary buffer
-            returnFloat[0] = floatToConvert[3];
-            returnFloat[1] = floatToConvert[2];
-            returnFloat[2] = floatToConvert[1];
-            returnFloat[3] = floatToConvert[0];
-
-
-            Common::Logger::globalInfo(Common::Logger::L2,"Received request to write float, Correct val is:  ", to_string(retVal).c_str());
-            wrQueue->second.push_back( std::make_pair( addressOptions[ADDRESS_OPTIONS_VAR], correctval));
-          } else {
-            char *correctval = new char[length];
-            std::memcpy(correctval, objPtr->getDataPtr(), length);
-            Common::Logger::globalInfo(Common::Logger::L2,"Received request to write non integer/float: ", correctval);
-            wrQueue->second.push_back( std::make_pair( addressOptions[ADDRESS_OPTIONS_VAR], correctval));
+          if(!session->pushWrite(addressOptions[ADDRESS_OPTIONS_VAR], kind, reinterpret_cast<const char*>(objPtr->getDataPtr()), objPtr->getDlen(),
+                                 lane == S7200Lane::Critical)) {
+            Common::Logger::globalWarning(__PRETTY_FUNCTION__, "Value cannot be written to address:", objPtr->getAddress().c_str());
+            return PVSS_FALSE;
           }
 
           Common::Logger::globalInfo(Common::Logger::L1,"Added write request to queue",objPtr->getAddress(), objPtr->getInfo() );
@@ -427,7 +567,9 @@ void handleSegfault(int signal_code){
 
     // print out all the frames to stderr
     fprintf(stderr, "Error: signal %d:\n", signal_code);
-    Common::Logger::globalWarning("S7200HWService suffered a segmentation fault, code " + CharString(signal_code));
+    // the process is about to die: bypass the asynchronous log sink
+    ErrHdl::error(ErrClass::PRIO_WARNING, ErrClass::ERR_CONTROL, ErrClass::NOERR,
+                  "S7200HWService suffered a segmentation fault, code " + CharString(signal_code));
     backtrace_symbols_fd(array, size, STDERR_FILENO);
 
     // restore and trigger default handle (to get the core dump)
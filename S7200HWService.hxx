@@ -18,6 +18,7 @@
 #include <HWService.hxx>
 #include <memory>
 #include "S7200LibFacade.hxx"
+#include "S7200PlcSession.hxx"
 
 #include "Common/Logger.hxx"
 #include <queue>
@@ -35,38 +36,67 @@ class S7200HWService : public HWService
     virtual void stop();
     virtual void workProc();
     virtual PVSSboolean writeData(HWObject *objPtr);
-    std::map < std::string , std::vector< std::pair<std::string, void*> > > writeQueueForIP;
-    std::set<std::string> IPAddressList;
     int CheckIP(std::string);
 
 private:
     void handleConsumerConfigError(const std::string&, int, const std::string&);
 
     void handleConsumeNewMessage(const std::string&, const std::string&, const std::string&, char*);
+    void handleConsumeBatch(const std::string& ip, std::vector<S7200BatchValue>& values, bool invalid);
     void handleNewIPAddress(const std::string& ip);
 
     errorCallbackConsumer _configErrorConsumerCB{[this](const std::string& ip, int err, const std::string& reason) { this->handleConsumerConfigError(ip, err, reason);}};
     consumeCallbackConsumer  _configConsumeCB{[this](const std::string& ip, const std::string& var, const std::string& pollTime, char* payload){this->handleConsumeNewMessage(ip, var, pollTime,std::move(payload));}};
+    batchCallbackConsumer _batchConsumeCB{[this](const std::string& ip, std::vector<S7200BatchValue>& values, bool invalid){this->handleConsumeBatch(ip, values, invalid);}};
     std::function<void(const std::string&)> _newIPAddressCB{[this](const std::string& ip){this->handleNewIPAddress(ip);}};
 
     //Common
     void insertInDataToDp(CharString&& address, char* value);
+    void sendToDp(HWObject& obj, const CharString& address, char* value, bool invalid, const TimeVar& time);
     std::mutex _toDPmutex;
     
     std::map < std::string, int > DisconnectsPerIP;
-    std::queue<std::pair<CharString,char*>> _toDPqueue;
+
+    /**
+     * @brief A value to send to WinCC OA, or a batch of values of one PLC sent together with the same invalid bit.
+     * The time is the one of the read (when the value was queued), not the one of the workProc that sends it.
+     */
+    struct ToDp
+    {
+        CharString address;
+        char* value{nullptr};
+        bool invalid{false};
+        std::vector<std::pair<CharString, char*>> batch;
+        TimeVar time;
+
+        ToDp() {}
+        ToDp(CharString&& a, char* v) : address(std::move(a)), value(v) {}
+        ToDp(CharString&& a, char* v, const TimeVar& t) : address(std::move(a)), value(v), time(t) {}
+    };
+    std::queue<ToDp> _toDPqueue;
+
+    // Redundancy: state seen by the last workProc, and last values polled while passive with their read time
+    struct StandbyValue
+    {
+        char* value{nullptr};
+        TimeVar time;
+    };
+    bool _passive{false};
+    std::map<std::string, StandbyValue> _standbyCache;
 
     enum
     {
        ADDRESS_OPTIONS_IP = 0,
        ADDRESS_OPTIONS_VAR,
        ADDRESS_OPTIONS_POLLTIME,
-       ADDRESS_OPTIONS_SIZE
+       ADDRESS_OPTIONS_SIZE,
+       ADDRESS_OPTIONS_LANE = ADDRESS_OPTIONS_SIZE, // optional
     } ADDRESS_OPTIONS;
 
-    std::vector<std::thread> _pollingThreads;
-
-    std::map<std::string, S7200LibFacade*> _facades;
+    // One session per polled PLC
+    S7200SessionRegistry _sessions;
+    // PLCs added by the address configuration, waiting for their session
+    std::set<std::string> _pendingIPs;
 };
 
 
@@ -17,26 +17,54 @@
 #include "S7200LibFacade.hxx"
 #include "Common/Constants.hxx"
 #include "Common/Logger.hxx"
+#include "Common/StringCodec.hxx"
+#include "Common/ValueStore.hxx"
+#include "S7200Watchdog.hxx"
 
 #include <algorithm>
+#include <set>
 #include <vector>
 
 
-S7200LibFacade::S7200LibFacade(const std::string& ip, consumeCallbackConsumer cb, errorCallbackConsumer erc = nullptr)
-    : _ip(ip), _consumeCB(cb), _errorCB(erc)
+S7200LibFacade::S7200LibFacade(const std::string& ip, const Common::ConnectionSettings& settings, consumeCallbackConsumer cb, errorCallbackConsumer erc,
+                               batchCallbackConsumer bcb)
+    : _ip(ip), _settings(settings), _settingsGeneration(~0u), _consumeCB(cb), _errorCB(erc), _batchCB(bcb)
 {
+     _callDeadline = _settings.callDeadline;
      Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, "Initialized LibFacade with IP: ", _ip.c_str());
 }
 
+S7200LibFacade::~S7200LibFacade()
+{
+    S7200Watchdog::getInstance().forget(this);
+}
+
+std::atomic<bool> S7200LibFacade::_cancelled{false};
+
 void S7200LibFacade::Connect()
 {
-    Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, "Snap7: Connecting to : Local TSAP Port : Remote TSAP Port'", (_ip + " : "+ std::to_string(Common::Constants::getLocalTsapPort()) + ":" + std::to_string(Common::Constants::getRemoteTsapPort())).c_str());
+    S7200_LOG_INFO(Common::Logger::L1, __PRETTY_FUNCTION__, " Snap7: Connecting to : Local TSAP Port : Remote TSAP Port' ", _ip, " : ", _settings.localTsap, ":", _settings.remoteTsap);
+    openConnection();
+}
+
+void S7200LibFacade::Reconnect()
+{
+    S7200_LOG_INFO(Common::Logger::L1, __PRETTY_FUNCTION__, " Snap7: Reconnecting to : Local TSAP Port : Remote TSAP Port' ", _ip, " : ", _settings.localTsap, ":", _settings.remoteTsap);
+    openConnection();
+}
 
+void S7200LibFacade::openConnection()
+{
     try{
-        _client = new TS7Client();
+        resetClient();
 
-        _client->SetConnectionParams(_ip.c_str(), Common::Constants::getLocalTsapPort(), Common::Constants::getRemoteTsapPort());
-        int res = _client->Connect();
+        setConnectionParams();
+        // the driver is stopping: do not wait for the connect timeout
+        int res = -1;
+        if(!_cancelled) {
+            TrackedCall call(*this);
+            res = _client->Connect();
+        }
 
 
         if (res==0) {
@@ -44,6 +72,9 @@ void S7200LibFacade::Connect()
             //printf("  PDU Requested  : %d bytes\n",Client->PDURequested());
             //printf("  PDU Negotiated : %d bytes\n",Client->PDULength());
             _initialized = true;
+            _linkDown = false;
+            _scanTimeSupported = true;
+            _lastAnswer = std::chrono::steady_clock::now();
         }
     }
     catch(std::exception& e)
@@ -52,28 +83,84 @@ void S7200LibFacade::Connect()
     }
 }
 
-void S7200LibFacade::Reconnect()
+void S7200LibFacade::resetClient()
 {
- Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, "Snap7: Reconnecting to : Local TSAP Port : Remote TSAP Port'", (_ip + " : "+ std::to_string(Common::Constants::getLocalTsapPort()) + ":" + std::to_string(Common::Constants::getRemoteTsapPort())).c_str());
+    std::lock_guard<std::mutex> lock{_clientMutex};
+    // the previous client (and its socket) is closed and released
+    if(_client)
+        _client->Disconnect();
+    _client.reset(new TS7Client());
+}
 
-    try{
-        _client = new TS7Client();
+S7200LibFacade::TrackedCall::TrackedCall(S7200LibFacade& f) : facade(f), watched(f._callDeadline > 0)
+{
+    {
+        std::lock_guard<std::mutex> lock{facade._clientMutex};
+        facade._callLate = false;
+        facade._callStart = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    if(watched)
+        S7200Watchdog::getInstance().track(&facade);
+}
 
-        _client->SetConnectionParams(_ip.c_str(), Common::Constants::getLocalTsapPort(), Common::Constants::getRemoteTsapPort());
-        int res = _client->Connect();
+S7200LibFacade::TrackedCall::~TrackedCall()
+{
+    {
+        std::lock_guard<std::mutex> lock{facade._clientMutex};
+        facade._callStart = 0;
+    }
+    if(watched)
+        S7200Watchdog::getInstance().untrack(&facade);
+}
 
+bool S7200LibFacade::checkDeadline(std::chrono::time_point<std::chrono::steady_clock> now)
+{
+    int deadline = _callDeadline;
+    if(deadline <= 0)
+        return false;
 
-        if (res==0) {
-            Common::Logger::globalInfo(Common::Logger::L1,__PRETTY_FUNCTION__, "Snap7: Connected to '", _ip.c_str());
-            //printf("  PDU Requested  : %d bytes\n",Client->PDURequested());
-            //printf("  PDU Negotiated : %d bytes\n",Client->PDULength());
-            _initialized = true;
-        }
-    }
-    catch(std::exception& e)
+    int64_t elapsed;
     {
-        Common::Logger::globalWarning("Snap7: Unable to initialize connection!", e.what());
+        // the call cannot end, nor another one start, until the connection is closed
+        std::lock_guard<std::mutex> lock{_clientMutex};
+        if(_callStart == 0 || _callLate)
+            return false;
+        elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count() - _callStart;
+        if(elapsed < (int64_t) deadline * 1000000)
+            return false;
+
+        // The call is stuck (half-open connection, CP overloaded): closing the socket makes it fail,
+        // the polling thread then reconnects
+        _callLate = true;
+        _linkDown = true;
+        _client->Disconnect();
     }
+
+    _watchdogEvents++;
+    S7200_LOG_WARNING(__PRETTY_FUNCTION__, " snap7 call to ", _ip, " still running after (ms): ", elapsed / 1000000);
+    S7200MarkDeviceConnectionError(_ip, true);
+    publishStatus("_Watchdog", (int16_t) std::min(_watchdogEvents, (int) INT16_MAX));
+    return true;
+}
+
+void S7200LibFacade::setConnectionParams()
+{
+    _client->SetConnectionParams(_ip.c_str(), _settings.localTsap, _settings.remoteTsap);
+
+    // 0 keeps the snap7 default
+    if(_settings.connectTimeout > 0)
+        _client->SetParam(p_i32_PingTimeout, &_settings.connectTimeout);
+    if(_settings.sendTimeout > 0)
+        _client->SetParam(p_i32_SendTimeout, &_settings.sendTimeout);
+    if(_settings.recvTimeout > 0)
+        _client->SetParam(p_i32_RecvTimeout, &_settings.recvTimeout);
+}
+
+int S7200LibFacade::getPduSize()
+{
+    // the configured size is a cap, never exceed what the PLC negotiated
+    int negotiated = _client->PDULength();
+    return negotiated > 0 ? std::min(_settings.pduSize, negotiated) : _settings.pduSize;
 }
 
 void S7200LibFacade::Disconnect()
@@ -96,71 +183,814 @@ void S7200LibFacade::Disconnect()
 }
 
 void S7200LibFacade::clearLastWriteTimeList() {
-    lastWritePerAddress.clear();
-    //clear() destroys all the elements in the map
-}
-
-void S7200LibFacade::Poll(std::vector<std::pair<std::string, int>>& vars, std::chrono::time_point<std::chrono::steady_clock> loopStartTime)
-{
-    std::vector<std::pair<std::string, void *>> addresses;
-
-    for (uint i = 0 ; i < vars.size() ; i++) {
-        if(S7200AddressIsValid(vars[i].first)){
-            if(lastWritePerAddress.count(vars[i].first) == 0) {
-                lastWritePerAddress.insert(std::pair<std::string, std::chrono::time_point<std::chrono::steady_clock>>(vars[i].first, loopStartTime));
-                Common::Logger::globalInfo(Common::Logger::L3,"Added to lastWritePerAddress queue: address", vars[i].first.c_str());
-                addresses.push_back(std::pair<std::string, void *>(vars[i].first, (void *)&vars[i].second));
-            } else{
-                int fpollTime;
-                int fpollingInterval = std::chrono::seconds(Common::Constants::getPollingInterval()).count() > 0 ? std::chrono::seconds(Common::Constants::getPollingInterval()).count() : 2;  
-
-                if(fpollingInterval < vars[i].second) {
-                    fpollTime = vars[i].second;
-                } else {
-                    fpollTime = fpollingInterval;
-                    //Common::Logger::globalInfo(Common::Logger::L1,"Using default polling Interval for address", vars[i].first.c_str());
-                    //Common::Logger::globalInfo(Common::Logger::L1,"Default polling Interval: ", std::to_string(fpollingInterval).c_str());
-                }
-
-                std::chrono::duration<double> tDiff = loopStartTime - lastWritePerAddress[vars[i].first];
-                if((int)tDiff.count() >= fpollTime) {
-                    lastWritePerAddress[vars[i].first] = loopStartTime;
-                    addresses.push_back(std::pair<std::string, void *>(vars[i].first, (void *)&vars[i].second));
-                }
+    // every address is read again at the next poll
+    for(auto& entry : _table)
+        entry.polled = false;
+}
+
+void S7200LibFacade::setAddresses(std::vector<S7200PollAddress>&& vars)
+{
+    _tableSource = std::move(vars);
+    _tableChanged = true;
+}
+
+void S7200LibFacade::Poll(std::chrono::time_point<std::chrono::steady_clock> loopStartTime)
+{
+    // Pick up the settings changed at runtime
+    unsigned generation = Common::ConnectionSettings::generation();
+    if(generation != _settingsGeneration) {
+        _settings = Common::ConnectionSettings::compile(_ip);
+        _settingsGeneration = generation;
+        _callDeadline = _settings.callDeadline;
+    }
+
+    auto pollStart = std::chrono::steady_clock::now();
+    _pollStart = pollStart;
+    _busyTime = std::chrono::steady_clock::duration::zero();
+    bool lagging = false;
+
+    if(_tableChanged || _settings.mirror != _tableMirror || _settings.coalesceGap != _tableGap)
+        compileTable();
+
+    // Due set of this cycle, as a bitmap over the compiled address table
+    std::fill(_due.begin(), _due.end(), 0);
+    size_t dueCount = 0;
+
+    for (uint i = 0 ; i < _table.size() ; i++) {
+        CompiledAddress& entry = _table[i];
+        // mirrored addresses are delivered by their span, quarantined ones are retried alone
+        if(!entry.valid || entry.mirrored || entry.quarantined)
+            continue;
+
+        if(entry.polled) {
+            int fpollTime = periodOf(entry);
+            std::chrono::duration<double> tDiff = loopStartTime - entry.lastRead;
+            if((int)tDiff.count() < fpollTime)
+                continue;
+            // read more than one cycle after its deadline
+            if((int)tDiff.count() > fpollTime + 1)
+                lagging = true;
+        } else {
+            S7200_LOG_INFO(Common::Logger::L3, "First read of address ", entry.address.var);
+        }
+
+        entry.previousRead = entry.lastRead;
+        entry.previouslyPolled = entry.polled;
+        entry.lastRead = loopStartTime;
+        entry.polled = true;
+        _due[i / 64] |= (uint64_t) 1 << (i % 64);
+        dueCount++;
+    }
+
+    if(dueCount == 0) {
+        S7200_LOG_INFO(Common::Logger::L2, "Valid vars size is 0, did not call read");
+    } else if(readDue(planFor(_due), loopStartTime) < dueCount) {
+        lagging = true;
+    }
+
+    if(_quarantined > 0)
+        retryQuarantined(loopStartTime);
+    if(!_revalidated.empty())
+        flushRevalidated();
+
+    if(_quarantined != _publishedQuarantined) {
+        _publishedQuarantined = _quarantined;
+        publishStatus("_Quarantined", (int16_t) std::min(_quarantined, (int) INT16_MAX));
+    }
+
+    if(_settings.scanTimeInterval > 0 && _scanTimeSupported)
+        monitorScanTime(loopStartTime);
+
+    // Adapt the rate of the slow addresses to the load of the link: the busy time is the largest of the
+    // time spent in Poll and the execution time measured by snap7
+    auto busy = std::max<std::chrono::steady_clock::duration>(std::chrono::steady_clock::now() - pollStart, _busyTime);
+    if(_lastCycleStart.time_since_epoch().count() != 0)
+        _controller.update(busy, loopStartTime - _lastCycleStart, lagging);
+    _lastCycleStart = loopStartTime;
+
+    if(_controller.getRatePercent() != _publishedRate) {
+        _publishedRate = _controller.getRatePercent();
+        S7200_LOG_INFO(Common::Logger::L1, __PRETTY_FUNCTION__, " Polling rate of the slow addresses of ", _ip, " set to ", _publishedRate, "%");
+        publishStatus("_PollRate", _publishedRate);
+    }
+
+    publishLaneLatencies(loopStartTime);
+
+    if(_settings.keepaliveIdle > 0)
+        keepAlive(std::chrono::steady_clock::now());
+
+    if(S7200Snapshot::getInstance().isEnabled() && loopStartTime - _lastSnapshot >= std::chrono::seconds(Common::Constants::getSnapshotInterval()))
+        saveSnapshot();
+}
+
+void S7200LibFacade::saveSnapshot()
+{
+    if(!S7200Snapshot::getInstance().isEnabled())
+        return;
+
+    S7200Snapshot::Plc plc;
+    for(const auto& entry : _table) {
+        if(!entry.valid || !entry.members.empty() || entry.timestamp == 0)
+            continue;
+        S7200Snapshot::Value& value = plc[entry.address.var];
+        value.suffix = entry.address.suffix;
+        value.timestamp = entry.timestamp;
+        value.value = entry.buffer;
+    }
+    S7200Snapshot::getInstance().update(_ip, std::move(plc));
+    _lastSnapshot = std::chrono::steady_clock::now();
+}
+
+void S7200LibFacade::restoreSnapshot()
+{
+    if(_warmStart) {
+        _warmStart = false;
+        S7200Snapshot::getInstance().restore(_ip, _warmValues);
+    }
+    if(_warmValues.empty())
+        return;
+
+    // only the addresses still configured with the same polling suffix and size take their value back
+    uint restored = 0;
+    for(auto& entry : _table) {
+        if(!entry.valid || !entry.members.empty())
+            continue;
+        auto found = _warmValues.find(entry.address.var);
+        if(found == _warmValues.end())
+            continue;
+        if(found->second.suffix == entry.address.suffix && (int) found->second.value.size() == entry.size) {
+            std::memcpy(entry.buffer.data(), found->second.value.data(), entry.size);
+            entry.timestamp = found->second.timestamp;
+            // in mirror mode only the changes since the snapshot are sent
+            entry.polled = entry.mirrored;
+            Common::ValueStore::getInstance().update(entry.storeSlot, entry.buffer.data(), entry.size, entry.timestamp);
+            restored++;
+        }
+        _warmValues.erase(found);
+    }
+    S7200_LOG_INFO(Common::Logger::L1, __PRETTY_FUNCTION__, " Warm start of ", _ip, ": ", restored, " values restored");
+}
+
+void S7200LibFacade::compileTable()
+{
+    const std::vector<S7200PollAddress>& vars = _tableSource;
+    // keep the read times of the addresses still polled
+    std::map<std::string, std::pair<bool, std::chrono::time_point<std::chrono::steady_clock>>> reads;
+    for(const auto& entry : _table)
+        reads[entry.address.var] = std::make_pair(entry.polled, entry.lastRead);
+
+    _table.clear();
+    _quarantined = 0;
+    // the mirror spans are added after the addresses, at most one per address
+    _table.reserve(2 * vars.size());
+    _planCache.clear();
+    _fastPeriod = 0;
+
+    for(const auto& var : vars) {
+        _table.push_back(CompiledAddress(var));
+        CompiledAddress& entry = _table.back();
+        entry.valid = S7200AddressIsValid(var.var);
+        if(!entry.valid)
+            continue;
+
+        entry.item = S7200TS7DataItemFromAddress(var.var);
+        delete[] static_cast<char*>(entry.item.pdata);
+        entry.size = S7200DataSizeByte(entry.item.WordLen) * entry.item.Amount;
+        entry.buffer.assign(entry.size, 0);
+        entry.item.pdata = entry.buffer.data();
+        entry.storeSlot = Common::ValueStore::getInstance().slot(_ip + "$" + var.var);
+
+        auto read = reads.find(var.var);
+        if(read != reads.end()) {
+            entry.polled = read->second.first;
+            entry.lastRead = read->second.second;
+        }
+
+        if(_fastPeriod == 0 || var.pollTime < _fastPeriod)
+            _fastPeriod = var.pollTime;
+    }
+
+    _tableChanged = false;
+    _tableMirror = _settings.mirror;
+    _tableGap = _settings.coalesceGap;
+    if(_tableMirror)
+        compileMirror();
+    restoreSnapshot();
+    _due.assign((_table.size() + 63) / 64, 0);
+    S7200_LOG_INFO(Common::Logger::L2, __PRETTY_FUNCTION__, " Compiled ", _table.size(), " addresses for ", _ip);
+}
+
+void S7200LibFacade::compileMirror()
+{
+    // byte range [first, last) of each V address
+    std::vector<std::pair<std::pair<int, int>, uint>> ranges;
+    for(uint i = 0; i < _table.size(); i++) {
+        const CompiledAddress& entry = _table[i];
+        if(!entry.valid || entry.item.Area != S7AreaDB)
+            continue;
+        int first = entry.item.WordLen == S7WLBit ? entry.item.Start / 8 : entry.item.Start;
+        int last = entry.item.WordLen == S7WLBit ? first + 1 : first + entry.size;
+        ranges.push_back(std::make_pair(std::make_pair(first, last), i));
+    }
+    std::sort(ranges.begin(), ranges.end());
+
+    // Addresses less than coalesceGap bytes apart share a span, read at the fastest period and lane of its addresses
+    for(uint r = 0; r < ranges.size();) {
+        int first = ranges[r].first.first;
+        int last = ranges[r].first.second;
+        uint end = r + 1;
+        while(end < ranges.size() && ranges[end].first.first <= last + _settings.coalesceGap) {
+            last = std::max(last, ranges[end].first.second);
+            end++;
+        }
+
+        int period = _table[ranges[r].second].address.pollTime;
+        S7200Lane lane = _table[ranges[r].second].address.lane;
+        for(uint m = r; m < end; m++) {
+            period = std::min(period, _table[ranges[m].second].address.pollTime);
+            lane = std::min(lane, _table[ranges[m].second].address.lane);
+        }
+
+        std::string var = "VB" + std::to_string(first) + "[" + std::to_string(last - first) + "]";
+        _table.push_back(CompiledAddress(S7200PollAddress(var, std::to_string(period), S7200PollAddress::laneName(lane))));
+        CompiledAddress& span = _table.back();
+        span.valid = true;
+        span.item = S7200TS7DataItemFromAddress(var);
+        delete[] static_cast<char*>(span.item.pdata);
+        span.size = last - first;
+        span.buffer.assign(span.size, 0);
+        span.item.pdata = span.buffer.data();
+
+        for(uint m = r; m < end; m++) {
+            CompiledAddress& member = _table[ranges[m].second];
+            member.mirrored = true;
+            member.span = _table.size() - 1;
+            span.members.push_back(ranges[m].second);
+        }
+        S7200_LOG_INFO(Common::Logger::L2, __PRETTY_FUNCTION__, " Mirror of ", _ip, ": ", var, " for ", end - r, " addresses");
+        r = end;
+    }
+}
+
+int S7200LibFacade::periodOf(const CompiledAddress& entry)
+{
+    int fpollingInterval = _settings.pollingInterval > 0 ? _settings.pollingInterval : 2;
+    int fpollTime = std::max(fpollingInterval, entry.address.pollTime);
+    // Fast addresses (critical lane, or the shortest period on this PLC) are never stretched by the controller
+    return _controller.effectivePeriod(fpollTime, entry.address.lane == S7200Lane::Critical || entry.address.pollTime <= _fastPeriod);
+}
+
+const S7200LibFacade::CachedPlan& S7200LibFacade::planFor(const std::vector<uint64_t>& due)
+{
+    int pduSize = getPduSize();
+    if(pduSize != _planPduSize || _planCache.size() >= PLAN_CACHE_SIZE) {
+        _planCache.clear();
+        _planPduSize = pduSize;
+    }
+
+    auto cached = _planCache.find(due);
+    if(cached != _planCache.end())
+        return cached->second;
+
+    // New due set: pack it and build the TS7DataItem arrays of its frames once.
+    // An address bigger than a frame is split into chunks that the planner packs like the other items.
+    std::vector<TS7DataItem> items;
+    std::vector<uint> entries;
+    std::vector<S7200ReadPlanner::Item> sizes;
+    CachedPlan& plan = _planCache[due];
+
+    for(uint i = 0; i < _table.size(); i++) {
+        if(!(due[i / 64] & ((uint64_t) 1 << (i % 64))))
+            continue;
+
+        const CompiledAddress& entry = _table[i];
+        std::vector<TS7DataItem> chunks = chunkItem(entry, pduSize);
+        if(chunks.size() > 1)
+            plan.chunks[i] = chunks.size();
+
+        for(const auto& chunk : chunks) {
+            items.push_back(chunk);
+            entries.push_back(i);
+            sizes.push_back(S7200ReadPlanner::Item{chunk.Amount * S7200DataSizeByte(chunk.WordLen), (int) entry.address.lane});
+        }
+    }
+
+    for(const auto& frame : _readPlanner.plan(sizes, pduSize, OVERHEAD_READ_VARIABLE, OVERHEAD_READ_MESSAGE, MAX_READ_ITEMS, false)) {
+        plan.entries.push_back(std::vector<uint>());
+        plan.frames.push_back(std::vector<TS7DataItem>());
+        for(uint i : frame) {
+            plan.entries.back().push_back(entries[i]);
+            plan.frames.back().push_back(items[i]);
+        }
+    }
+    return plan;
+}
+
+std::vector<TS7DataItem> S7200LibFacade::chunkItem(const CompiledAddress& entry, int pduSize) const
+{
+    int elementSize = S7200DataSizeByte(entry.item.WordLen);
+    // largest even payload that fits alone in a response frame
+    int maxChunk = (pduSize - OVERHEAD_READ_MESSAGE - 1 - OVERHEAD_READ_VARIABLE) & ~1;
+    int perChunk = std::max(1, maxChunk / elementSize);
+
+    std::vector<TS7DataItem> chunks;
+    if(entry.item.Amount <= perChunk || entry.item.WordLen == S7WLBit) {
+        chunks.push_back(entry.item);
+        return chunks;
+    }
+
+    // Timers and counters are addressed by index, the other areas by byte
+    int startStep = (entry.item.WordLen == S7WLTimer || entry.item.WordLen == S7WLCounter) ? 1 : elementSize;
+    for(int done = 0; done < entry.item.Amount; done += perChunk) {
+        TS7DataItem chunk = entry.item;
+        chunk.Start = entry.item.Start + done * startStep;
+        chunk.Amount = std::min(perChunk, entry.item.Amount - done);
+        chunk.pdata = static_cast<char*>(entry.item.pdata) + done * elementSize;
+        chunks.push_back(chunk);
+    }
+    return chunks;
+}
+
+uint S7200LibFacade::readDue(const CachedPlan& plan, std::chrono::time_point<std::chrono::steady_clock> loopStartTime)
+{
+    // addresses sent, a chunked one once the frame of its last chunk is sent
+    uint read = 0;
+    std::map<uint, uint> unsent(plan.chunks);
+    // chunks still expected for each chunked address, and the chunked addresses with a failed chunk
+    std::map<uint, uint> pending(plan.chunks);
+    std::set<uint> failed;
+
+    for(uint f = 0; f < plan.frames.size() && !_cancelled && !_linkDown; f++) {
+        const std::vector<uint>& entries = plan.entries[f];
+
+        if(_settings.maxFrames > 0 && f >= (uint) _settings.maxFrames) {
+            // left out by the frame limit: stays due for the next cycle
+            for(uint i : entries) {
+                _table[i].lastRead = _table[i].previousRead;
+                _table[i].polled = _table[i].previouslyPolled;
+            }
+            continue;
+        }
+
+        std::vector<TS7DataItem>& frame = const_cast<std::vector<TS7DataItem>&>(plan.frames[f]);
+        _itemErrors.resize(frame.size());
+        int retOpt = readItems(frame.data(), frame.size(), _itemErrors.data());
+        for(uint i : entries) {
+            auto chunks = unsent.find(i);
+            if(chunks == unsent.end() || --chunks->second == 0)
+                read++;
+        }
+
+        if(retOpt != 0) {
+            // the link is in trouble: counts towards a reconnection
+            S7200_LOG_INFO(Common::Logger::L1, "-->Read NOK ", CliErrorText(retOpt));
+            readFailures++;
+            for(uint i : entries) {
+                if(pending.count(i))
+                    failed.insert(i);
+            }
+            continue;
+        }
+
+        S7200_LOG_INFO(Common::Logger::L3, "Read OK");
+        auto latency = std::chrono::steady_clock::now() - _pollStart;
+        int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        for(uint k = 0; k < entries.size(); k++) {
+            uint i = entries[k];
+            auto chunks = pending.find(i);
+            if(_itemErrors[k] != 0) {
+                if(chunks != pending.end())
+                    failed.insert(i);
+                if(!_table[i].quarantined)
+                    quarantine(i, _itemErrors[k]);
+                continue;
             }
+
+            // a chunked address is delivered once its last chunk is in the buffer
+            if(chunks != pending.end() && (--chunks->second > 0 || failed.count(i)))
+                continue;
+
+            _laneLatency[(int) _table[i].address.lane] = std::max(_laneLatency[(int) _table[i].address.lane], latency);
+            deliver(i, loopStartTime, timestamp);
+        }
+    }
+    return read;
+}
+
+int S7200LibFacade::readItems(TS7DataItem* items, int count, int* errors)
+{
+    int result;
+    {
+        TrackedCall call(*this);
+        result = _client->ReadMultiVars(items, count);
+    }
+    _busyTime += std::chrono::milliseconds(_client->ExecTime());
+    if(!isTransportError(result))
+        _lastAnswer = std::chrono::steady_clock::now();
+
+    if(result == 0) {
+        // the exchange went fine, each item has its own result
+        for(int k = 0; k < count; k++)
+            errors[k] = items[k].Result;
+        return 0;
+    }
+    if(isTransportError(result))
+        return result;
+
+    if(count == 1) {
+        errors[0] = result;
+        return 0;
+    }
+
+    // The PLC refused the whole request: split it to find the items responsible
+    S7200_LOG_INFO(Common::Logger::L2, __PRETTY_FUNCTION__, " Request of ", count, " items refused by ", _ip, ": ", CliErrorText(result));
+    int half = count / 2;
+    result = readItems(items, half, errors);
+    return result != 0 ? result : readItems(items + half, count - half, errors + half);
+}
+
+bool S7200LibFacade::isTransportError(int error)
+{
+    // socket (low word) and ISO layer errors, or no valid answer from the PLC
+    return error < 0 || (error & 0x000FFFFF) != 0 ||
+           error == (int) errCliJobTimeout || error == (int) errCliInvalidPlcAnswer ||
+           error == (int) errNegotiatingPDU || error == (int) errCliDestroying || error == (int) errCliJobPending;
+}
+
+void S7200LibFacade::keepAlive(std::chrono::time_point<std::chrono::steady_clock> now)
+{
+    if(_linkDown || _cancelled || now - _lastAnswer < std::chrono::seconds(_settings.keepaliveIdle))
+        return;
+
+    // Read of VB0: only the error code is classified (PlcStatus() mixes the status with the small TCP errors).
+    // Any answer proves the link alive, even a refusal of the read
+    byte probe;
+    int result;
+    {
+        TrackedCall call(*this);
+        result = _client->ReadArea(S7AreaDB, 1, 0, 1, S7WLByte, &probe);
+    }
+    if(!isTransportError(result)) {
+        _lastAnswer = now;
+        S7200_LOG_INFO(Common::Logger::L3, __PRETTY_FUNCTION__, " Keepalive of ", _ip, " answered: ", result);
+        return;
+    }
+
+    S7200_LOG_WARNING(__PRETTY_FUNCTION__, " No answer from ", _ip, " to the keepalive: ", CliErrorText(result));
+    _linkDown = true;
+}
+
+void S7200LibFacade::monitorScanTime(std::chrono::time_point<std::chrono::steady_clock> now)
+{
+    if(_lastScanTimeRead.time_since_epoch().count() != 0 && now - _lastScanTimeRead < std::chrono::seconds(_settings.scanTimeInterval))
+        return;
+    _lastScanTimeRead = now;
+
+    if(!_szl)
+        _szl.reset(new TS7SZL());
+    int size = sizeof(TS7SZL);
+    int result;
+    {
+        TrackedCall call(*this);
+        // start information of OB1: the previous, minimum and maximum cycle times (ms) are INT at bytes 6, 8 and 10
+        result = _client->ReadSZL(0x0222, 0x0001, _szl.get(), &size);
+    }
+    _busyTime += std::chrono::milliseconds(_client->ExecTime());
+
+    if(result == 0 && (size < (int) sizeof(SZL_HEADER) + 12 || _szl->Header.LENTHDR < 12))
+        result = errCliInvalidPlcAnswer;
+    if(result != 0) {
+        if(!isTransportError(result)) {
+            // e.g. a CPU or CP which does not provide this list: do not ask again until the next connection
+            S7200_LOG_WARNING(__PRETTY_FUNCTION__, " ", _ip, " does not report its scan time: ", CliErrorText(result));
+            _scanTimeSupported = false;
+            _controller.setPlcOverloaded(false);
+        }
+        return;
+    }
+
+    const byte* info = _szl->Data;
+    int scanTime = (int16_t) ((info[6] << 8) | info[7]);
+    int scanTimeMax = (int16_t) ((info[10] << 8) | info[11]);
+    bool overloaded = _settings.scanTimeCeiling > 0 && scanTime > _settings.scanTimeCeiling;
+    S7200_LOG_INFO(Common::Logger::L3, __PRETTY_FUNCTION__, " Scan time of ", _ip, ": ", scanTime, " ms, max ", scanTimeMax, " ms");
+    _controller.setPlcOverloaded(overloaded);
+
+    if(scanTime != _publishedScanTime) {
+        _publishedScanTime = scanTime;
+        publishStatus("_ScanTime", (int16_t) scanTime);
+    }
+    if(scanTimeMax != _publishedScanTimeMax) {
+        _publishedScanTimeMax = scanTimeMax;
+        publishStatus("_ScanTimeMax", (int16_t) scanTimeMax);
+    }
+}
+
+void S7200LibFacade::deliver(uint index, std::chrono::time_point<std::chrono::steady_clock> loopStartTime, int64_t timestamp)
+{
+    CompiledAddress& entry = _table[index];
+    if(!entry.members.empty()) {
+        deliverMirror(entry, loopStartTime, timestamp);
+        return;
+    }
+
+    // copy of the value read, handed over with the callback
+    char* payload = new char[entry.size];
+    std::memcpy(payload, entry.buffer.data(), entry.size);
+    entry.timestamp = timestamp;
+    Common::ValueStore::getInstance().update(entry.storeSlot, payload, entry.size, timestamp);
+    send(entry, payload);
+}
+
+void S7200LibFacade::send(CompiledAddress& entry, char* payload)
+{
+    if(entry.invalid) {
+        // read again after the connection loss: waits for the others, a newer read replaces it
+        if(entry.revalidation >= 0) {
+            delete[] _revalidated[entry.revalidation].payload;
+            _revalidated[entry.revalidation].payload = payload;
+        } else {
+            entry.revalidation = _revalidated.size();
+            _revalidated.push_back(S7200BatchValue{entry.address.var, entry.address.suffix, payload});
         }
+        return;
     }
+    this->_consumeCB(_ip, entry.address.var, entry.address.suffix, payload);
+}
 
-    if(addresses.size() == 0) {
-        Common::Logger::globalInfo(Common::Logger::L2, "Valid vars size is 0, did not call read");
+void S7200LibFacade::flushRevalidated()
+{
+    // wait for every value invalidated, except the quarantined ones which stay invalid
+    for(const auto& entry : _table) {
+        if(entry.valid && entry.members.empty() && entry.invalid && entry.revalidation < 0 && !entry.quarantined)
+            return;
+    }
+
+    for(auto& entry : _table) {
+        if(entry.revalidation >= 0) {
+            entry.invalid = false;
+            entry.revalidation = -1;
+        }
+    }
+    S7200_LOG_INFO(Common::Logger::L1, __PRETTY_FUNCTION__, " ", _revalidated.size(), " values of ", _ip, " valid again");
+    _batchCB(_ip, _revalidated, false);
+    _revalidated.clear();
+}
+
+void S7200LibFacade::invalidateValues()
+{
+    if(!_batchCB)
         return;
+
+    std::vector<S7200BatchValue> values;
+    for(auto& entry : _table) {
+        if(!entry.valid || !entry.members.empty())
+            continue;
+        // read again as soon as the connection is back, in mirror mode every value is sent again
+        entry.polled = false;
+        // a value read again but not sent yet is still invalid in WinCC OA
+        entry.revalidation = -1;
+        if(entry.timestamp == 0 || entry.invalid)
+            continue;
+        entry.invalid = true;
+        char* payload = new char[entry.size];
+        std::memcpy(payload, entry.buffer.data(), entry.size);
+        values.push_back(S7200BatchValue{entry.address.var, entry.address.suffix, payload});
+    }
+    // values read before the connection was lost
+    for(auto& value : _revalidated)
+        delete[] value.payload;
+    _revalidated.clear();
+
+    if(values.empty())
+        return;
+    S7200_LOG_INFO(Common::Logger::L1, __PRETTY_FUNCTION__, " Connection to ", _ip, " lost, ", values.size(), " values set invalid");
+    _batchCB(_ip, values, true);
+}
+
+void S7200LibFacade::quarantine(uint index, int error)
+{
+    CompiledAddress& entry = _table[index];
+    if(!entry.quarantined) {
+        entry.quarantined = true;
+        entry.backoff = QUARANTINE_MIN_BACKOFF;
+        _quarantined++;
+    } else {
+        entry.backoff = std::min(2 * entry.backoff, QUARANTINE_MAX_BACKOFF);
     }
-    
-                       
-    // for(uint i = 0; i < addresses.size() ; i++) {
-    //     int a;
-    //     std::memcpy(&a, addresses[i].second, sizeof(int));    
-    //     Common::Logger::globalInfo(Common::Logger::L1,("Address: "+ addresses[i].first + "Polling Time" + std::to_string(a)).c_str());
-    // }
-    
-    S7200ReadWriteMaxN(addresses, 19, PDU_SIZE, OVERHEAD_READ_VARIABLE, OVERHEAD_READ_MESSAGE, OPERATION_READ);
+    entry.retryAt = std::chrono::steady_clock::now() + std::chrono::seconds(entry.backoff);
+    S7200_LOG_WARNING(__PRETTY_FUNCTION__, " ", _ip, "$", entry.address.var, " quarantined, retry in ", entry.backoff, " s: ", CliErrorText(error));
 }
 
-void S7200LibFacade::write(std::vector<std::pair<std::string, void *>> addresses) {
-    S7200ReadWriteMaxN(addresses, 12, PDU_SIZE, OVERHEAD_WRITE_VARIABLE, OVERHEAD_WRITE_MESSAGE, OPERATION_WRITE);
+void S7200LibFacade::retryQuarantined(std::chrono::time_point<std::chrono::steady_clock> loopStartTime)
+{
+    auto now = std::chrono::steady_clock::now();
+    int pduSize = getPduSize();
+
+    for(uint i = 0; i < _table.size() && _quarantined > 0 && !_cancelled && !_linkDown; i++) {
+        CompiledAddress& entry = _table[i];
+        if(!entry.quarantined || now < entry.retryAt)
+            continue;
+
+        // read alone, chunk by chunk
+        int error = 0;
+        for(auto& chunk : chunkItem(entry, pduSize)) {
+            if(readItems(&chunk, 1, &error) != 0)
+                return; // the link failed, not the address
+            if(error != 0)
+                break;
+        }
+
+        if(error != 0) {
+            quarantine(i, error);
+            continue;
+        }
 
-    for(uint i = 0; i < addresses.size(); i++) {
-        delete[] (char *)addresses[i].second;
+        S7200_LOG_INFO(Common::Logger::L1, __PRETTY_FUNCTION__, " Address back from quarantine: ", _ip, "$", entry.address.var);
+        entry.quarantined = false;
+        entry.backoff = 0;
+        entry.lastRead = loopStartTime;
+        entry.polled = true;
+        _quarantined--;
+        deliver(i, loopStartTime, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
     }
 }
 
-void S7200LibFacade::markForNextRead(std::vector<std::pair<std::string, void *>> addresses, std::chrono::time_point<std::chrono::steady_clock> loopFirstStartTime) {
-    for(auto & PairAddress: addresses) {
-         if(S7200AddressIsValid(PairAddress.first)){
-            if(lastWritePerAddress.count(PairAddress.first) != 0) {
-                lastWritePerAddress[PairAddress.first] = loopFirstStartTime;
+void S7200LibFacade::deliverMirror(const CompiledAddress& span, std::chrono::time_point<std::chrono::steady_clock> loopStartTime, int64_t timestamp)
+{
+    for(uint m : span.members) {
+        CompiledAddress& entry = _table[m];
+        // each address keeps its own polling time
+        if(entry.polled && (int) std::chrono::duration<double>(loopStartTime - entry.lastRead).count() < periodOf(entry))
+            continue;
+
+        // the value of the address, decoded from the span buffer
+        char* payload = new char[entry.size];
+        if(entry.item.WordLen == S7WLBit) {
+            payload[0] = (span.buffer[entry.item.Start / 8 - span.item.Start] >> (entry.item.Start % 8)) & 1;
+        } else {
+            std::memcpy(payload, span.buffer.data() + entry.item.Start - span.item.Start, entry.size);
+        }
+
+        // only the changes are delivered, and every value once after a (re)connection
+        bool changed = !entry.polled || std::memcmp(payload, entry.buffer.data(), entry.size) != 0;
+        entry.polled = true;
+        entry.lastRead = loopStartTime;
+        entry.timestamp = timestamp;
+        Common::ValueStore::getInstance().update(entry.storeSlot, payload, entry.size, timestamp);
+        if(!changed) {
+            delete[] payload;
+            continue;
+        }
+        std::memcpy(entry.buffer.data(), payload, entry.size);
+        send(entry, payload);
+    }
+}
+
+void S7200LibFacade::publishLaneLatencies(std::chrono::time_point<std::chrono::steady_clock> now)
+{
+    if(_latencyWindowStart.time_since_epoch().count() == 0)
+        _latencyWindowStart = now;
+    if(now - _latencyWindowStart < std::chrono::seconds(LANE_LATENCY_PERIOD))
+        return;
+
+    // Worst latency (ms) of each lane over the period, from the start of the cycle to the end of the read: sent when it changes
+    for(int lane = 0; lane < S7200_LANE_COUNT; lane++) {
+        int ms = (int) std::min<long>(std::chrono::duration_cast<std::chrono::milliseconds>(_laneLatency[lane]).count(), INT16_MAX);
+        if(ms != _publishedLatency[lane]) {
+            _publishedLatency[lane] = ms;
+            publishStatus(std::string("_Latency") + S7200PollAddress::laneName((S7200Lane) lane), (int16_t) ms);
+        }
+        _laneLatency[lane] = std::chrono::steady_clock::duration::zero();
+    }
+    _latencyWindowStart = now;
+}
+
+void S7200LibFacade::publishStatus(const std::string& var, int16_t value)
+{
+    // Status DPEs (IP$_PollRate) use the 16 bits integer transformation: big endian
+    char* payload = new char[sizeof(int16_t)];
+    payload[0] = (char) ((value >> 8) & 0xFF);
+    payload[1] = (char) (value & 0xFF);
+    this->_consumeCB(_ip, var, "", payload);
+}
+
+void S7200LibFacade::write(S7200WriteBuffer& writes) {
+    if(!writes.empty()) {
+        _writeLimiter.configure(_settings.writeFrameRate, _settings.writeByteRate);
+        _writeSent.assign(writes.size(), false);
+
+        // Critical writes first, never held back; the others in their order as long as the limiter allows
+        sendWrites(writes, true);
+        sendWrites(writes, false);
+
+        // the writes not sent because the link failed are lost, as the reads
+        if(_cancelled || _linkDown)
+            writes.clear();
+        else
+            writes.retain(_writeSent);
+
+        // A sustained burst above the limits: beyond the cap only the last value of each address is kept
+        if(writes.size() > MAX_HELD_WRITES) {
+            size_t dropped = writes.keepLatest();
+            _writesDropped += dropped;
+            if(dropped > 0)
+                S7200_LOG_INFO(Common::Logger::L1, __PRETTY_FUNCTION__, " ", dropped, " writes to ", _ip, " held back by the write limiter replaced by newer values");
+        }
+    }
+
+    // writes held back, and dropped so far
+    int throttled = writes.size() + _writesDropped;
+    if(throttled != _publishedThrottled) {
+        if(!writes.empty())
+            S7200_LOG_INFO(Common::Logger::L2, __PRETTY_FUNCTION__, " ", writes.size(), " writes to ", _ip, " held back by the write limiter");
+        _publishedThrottled = throttled;
+        publishStatus("_WritesThrottled", (int16_t) std::min(_publishedThrottled, (int) INT16_MAX));
+    }
+}
+
+void S7200LibFacade::sendWrites(S7200WriteBuffer& writes, bool critical) {
+    _writeIndex.clear();
+    for(uint i = 0; i < writes.size(); i++) {
+        if(writes.writes()[i].critical == critical)
+            _writeIndex.push_back(i);
+    }
+    if(_writeIndex.empty())
+        return;
+
+    // The items point to the values encoded in the buffer
+    _writeItems.resize(_writeIndex.size());
+    _writeSizes.resize(_writeIndex.size());
+    for(uint i = 0; i < _writeIndex.size(); i++) {
+        const S7200WriteBuffer::Write& write = writes.writes()[_writeIndex[i]];
+        _writeItems[i] = write.target->item;
+        _writeItems[i].pdata = writes.data(write);
+        _writeSizes[i].size = write.target->size;
+        _writeSizes[i].lane = 0;
+    }
+
+    // Writes keep their order
+    int pduSize = getPduSize();
+    const S7200ReadPlanner::Plan& plan = _writePlanner.plan(_writeSizes, pduSize, OVERHEAD_WRITE_VARIABLE, OVERHEAD_WRITE_MESSAGE, 12, true);
+
+    for(const auto& frame : plan) {
+        if(_cancelled || _linkDown)
+            break;
+
+        if(!critical) {
+            int bytes = 0;
+            for(uint i : frame)
+                bytes += _writeSizes[i].size;
+            if(!_writeLimiter.tryAcquire(bytes, std::chrono::steady_clock::now()))
+                break;
+        }
+        for(uint i : frame)
+            _writeSent[_writeIndex[i]] = true;
+
+        int retOpt;
+        bool multiVars = false;
+        {
+            TrackedCall call(*this);
+            if(frame.size() == 1 && _writeSizes[frame[0]].size + OVERHEAD_WRITE_VARIABLE >= pduSize - OVERHEAD_WRITE_MESSAGE) {
+                //This means that the current variable has a mem size > PDU. Call with WriteArea
+                const TS7DataItem& big = _writeItems[frame[0]];
+                retOpt = _client->WriteArea(big.Area, big.DBNumber, big.Start, big.Amount, big.WordLen, big.pdata);
+            } else {
+                multiVars = true;
+                _frameItems.clear();
+                for(uint i : frame)
+                    _frameItems.push_back(_writeItems[i]);
+                retOpt = _client->WriteMultiVars(_frameItems.data(), _frameItems.size());
             }
-         }
+        }
+
+        _busyTime += std::chrono::milliseconds(_client->ExecTime());
+        if(!isTransportError(retOpt))
+            _lastAnswer = std::chrono::steady_clock::now();
+
+        if(retOpt == 0) {
+            // the exchange went fine, each write has its own result
+            for(uint k = 0; multiVars && k < _frameItems.size(); k++) {
+                if(_frameItems[k].Result != 0)
+                    S7200_LOG_WARNING(__PRETTY_FUNCTION__, " ", _ip, "$", writes.writes()[_writeIndex[frame[k]]].target->var, " write refused: ",
+                                      CliErrorText(_frameItems[k].Result));
+            }
+            Common::Logger::globalInfo(Common::Logger::L1, "Write OK");
+        } else {
+            Common::Logger::globalInfo(Common::Logger::L1, "-->Write NOK");
+        }
+    }
+}
+
+void S7200LibFacade::markForNextRead(const S7200WriteBuffer& writes, std::chrono::time_point<std::chrono::steady_clock> loopFirstStartTime) {
+    for(const auto& write : writes.writes()) {
+        for(auto& entry : _table) {
+            if(entry.polled && entry.address.var == write.target->var) {
+                entry.lastRead = loopFirstStartTime;
+                if(entry.mirrored)
+                    _table[entry.span].lastRead = loopFirstStartTime;
+            }
+        }
     }
 }
 
@@ -247,9 +1077,17 @@ int S7200LibFacade::S7200AddressGetAmount(std::string S7200Address)
     if(S7200Address.length() < 2){
         return -1; //invalid
     }
+    else if(S7200AddressIsArray(S7200Address)){ //e.g.: VW200[64]
+        if(S7200Address.back() != ']'){
+            return -1; //invalid
+        }
+        int amount = (int) std::stoi(S7200Address.substr(S7200Address.find('[')+1));
+        return amount > 0 ? amount : -1;
+    }
     else if(std::tolower((char) S7200Address.at(1)) == 'b'){ //VB can be words or strings if it contains a '.'
         if(S7200Address.find_first_of('.') != std::string::npos){
-            return (int) std::stoi(S7200Address.substr(S7200Address.find('.')+1));
+            int amount = (int) std::stoi(S7200Address.substr(S7200Address.find('.')+1));
+            return S7200AddressIsS7String(S7200Address) ? amount + (int) Common::StringCodec::S7_HEADER_SIZE : amount; //e.g.: VB2978.20S
         }
         else{
             return 1;
@@ -264,6 +1102,21 @@ int S7200LibFacade::S7200AddressGetAmount(std::string S7200Address)
     return 0; //dummy
 }
 
+bool S7200LibFacade::S7200AddressIsArray(std::string S7200Address)
+{
+    return S7200Address.length() > 2 &&
+           (std::tolower((char) S7200Address.at(1)) == 'b' || std::tolower((char) S7200Address.at(1)) == 'w' || std::tolower((char) S7200Address.at(1)) == 'd') &&
+           S7200Address.find_first_of('[') != std::string::npos;
+}
+
+bool S7200LibFacade::S7200AddressIsS7String(std::string S7200Address)
+{
+    return S7200Address.length() > 2 &&
+           std::tolower((char) S7200Address.at(1)) == 'b' &&
+           S7200Address.find_first_of('.') != std::string::npos &&
+           std::tolower((char) S7200Address.back()) == 's';
+}
+
 int S7200LibFacade::S7200AddressGetBit(std::string S7200Address)
 {
     if(S7200Address.length() < 2){
@@ -298,8 +1151,7 @@ void S7200LibFacade::S7200DisplayTS7DataItem(PS7DataItem item)
     switch(item->WordLen){
         case S7WLByte:
             if(item->Amount>1){
-                std::string strVal( reinterpret_cast<char const*>(item->pdata));
-                //printf("-->read valus as string :'%s'\n", strVal.c_str());
+                //printf("-->read valus as string :'%.*s'\n", (int) item->Amount, static_cast<const char*>(item->pdata));
             }
             else{
                 uint8_t byteVal;
@@ -332,21 +1184,20 @@ TS7DataItem S7200LibFacade::S7200TS7DataItemFromAddress(std::string S7200Address
     item.Area     = S7200AddressGetArea(S7200Address);
     item.WordLen  = S7200AddressGetWordLen(S7200Address);
     item.DBNumber = 1;
+    item.Result   = 0;
     item.Start    = item.WordLen == S7WLBit ? (S7200AddressGetStart(S7200Address)*8)+S7200AddressGetBit(S7200Address) : S7200AddressGetStart(S7200Address);
     item.Amount   = S7200AddressGetAmount(S7200Address);
     item.pdata   = new char[S7200DataSizeByte(item.WordLen )*item.Amount];
     return item;
 }
 
-void S7200LibFacade::S7200MarkDeviceConnectionError(std::string ip, bool error_status){
-    if(error_status)
-        Common::Logger::globalInfo(Common::Logger::L1, "Request from LambdaThread: Writing true to DPE for PLC connection erorr for PLC IP : ", ip.c_str());
-    else
-        Common::Logger::globalInfo(Common::Logger::L1, "Request from LambdaThread: Writing false to DPE for PLC connection erorr for PLC IP : ", ip.c_str());
-    
-    TS7DataItem PLC_Conn_Stat_item = S7200TS7DataItemFromAddress("_Error");
-    memcpy(PLC_Conn_Stat_item.pdata, &error_status , sizeof(bool));
-    this->_consumeCB(ip, "_Error", "", reinterpret_cast<char*>(PLC_Conn_Stat_item.pdata));
+void S7200LibFacade::S7200MarkDeviceConnectionError(const std::string& ip, bool error_status){
+    S7200_LOG_INFO(Common::Logger::L1, "Request from LambdaThread: Writing ", error_status ? "true" : "false", " to DPE for PLC connection erorr for PLC IP : ", ip);
+
+    // _Error is a bool DPE: one byte
+    char* payload = new char[sizeof(bool)];
+    memcpy(payload, &error_status, sizeof(bool));
+    this->_consumeCB(ip, "_Error", "", payload);
 }
 
 float ReverseFloat( const float inFloat )
@@ -364,127 +1215,6 @@ float ReverseFloat( const float inFloat )
    return retVal;
 }
 
-TS7DataItem S7200LibFacade::initializeIfMissVar(std::string address) {
-    if(VarItems.count(address) == 0)
-        VarItems.insert( std::pair<std::string, TS7DataItem>(address, S7200TS7DataItemFromAddress(address)) );
-    else 
-        VarItems[address].pdata = new char[S7200DataSizeByte(VarItems[address].WordLen )*VarItems[address].Amount];
-
-    return VarItems[address];
-}
-
-
-void S7200LibFacade::S7200ReadWriteMaxN(std::vector <std::pair<std::string, void *>> validVars, uint N, int PDU_SZ, int VAR_OH, int MSG_OH, int rorw) {
-    try{
-        uint last_index = 0;
-        uint to_send = 0;
-
-        TS7DataItem item [validVars.size()];
-
-        for(uint i = 0; i < validVars.size(); i++) {
-           // Common::Logger::globalInfo(Common::Logger::L1,"Getting item with address", validVars[i].first.c_str());
-            item[i] = initializeIfMissVar(validVars[i].first);
-            
-            if(rorw == 1) {
-                int memSize = (S7200DataSizeByte(item[i].WordLen )*item[i].Amount);
-
-                if(S7200DataSizeByte(item[i].WordLen) == 2) {
-                    std::memcpy(item[i].pdata , validVars[i].second, sizeof(int16_t));
-                } else if (S7200DataSizeByte(item[i].WordLen) == 4) {
-                    std::memcpy(item[i].pdata , validVars[i].second, sizeof(float));
-                } else {
-                    //case string
-                    std::memcpy(item[i].pdata, validVars[i].second, memSize);
-                }
-            }
-        }
-
-        int retOpt;
-
-        int curr_sum;
-
-        last_index = 0;
-        while(last_index < validVars.size()) {
-            to_send = 0;
-            curr_sum = 0;
-            
-            uint i;
-            for(i = last_index; i < validVars.size(); i++) {
-                
-                if( curr_sum + (((S7200DataSizeByte(item[i].WordLen)) * item[i].Amount) + VAR_OH) < ( PDU_SZ - MSG_OH ) ) {
-                    to_send++;
-                    curr_sum += ((S7200DataSizeByte(item[i].WordLen)) * item[i].Amount) + VAR_OH;
-                } else{
-                    break;
-                }
-
-                if(to_send == N) { //Request upto N variables
-                    break;
-                }
-            }
-
-            if(to_send == 0) {
-                //This means that the current variable has a mem size > PDU. Call with ReadArea 
-                //printf("To read a single variable with index %d and total size %d\n", last_index, ((S7200DataSizeByte(item[i].WordLen)) * item[i].Amount));
-                to_send += 1;
-                curr_sum = ((S7200DataSizeByte(item[i].WordLen)) * item[i].Amount) + VAR_OH + MSG_OH;
-
-                if(rorw == 0)
-                    retOpt = _client->ReadArea(item[last_index].Area, item[last_index].DBNumber, item[last_index].Start, item[last_index].Amount, item[last_index].WordLen, item[last_index].pdata);
-                else
-                    retOpt = _client->WriteArea(item[last_index].Area, item[last_index].DBNumber, item[last_index].Start, item[last_index].Amount, item[last_index].WordLen, item[last_index].pdata);
-
-            } else {
-                //printf("To read %d variables, total requesting incl overheads: %d\n", to_send, curr_sum+MSG_OH);
-                //printf("To read variables from range %d to %d \n", last_index, last_index + to_send);
-
-                if(rorw == 0)
-                    retOpt = _client->ReadMultiVars(&(item[last_index]), to_send);
-                else {
-                    retOpt = _client->WriteMultiVars(&(item[last_index]), to_send);
-                }
-            }
-
-            if( retOpt == 0) {
-                //printf("Read/Write OK. ");
-                //printf("Read/Write %d items\n", to_send);
-
-                if(rorw == 0) {
-                    Common::Logger::globalInfo(Common::Logger::L3, "Read OK");
-                
-                    for(uint i = last_index; i < last_index + to_send; i++) {
-                        int a;
-                        std::memcpy(&a, validVars[i].second, sizeof(int));    
-                        this->_consumeCB(_ip, validVars[i].first, std::to_string(a), reinterpret_cast<char*>(item[i].pdata));
-                    }
-                } else {
-                    Common::Logger::globalInfo(Common::Logger::L1, "Write OK");
-                }
-            }
-            else{
-                if(rorw == 0) {
-                    //printf("-->Read NOK!, Tried to read %d elements with total requesting size: %d .retOpt is %d\n", to_send, curr_sum + MSG_OH, retOpt);
-                    Common::Logger::globalInfo(Common::Logger::L1, "-->Read NOK");
-                    readFailures++;
-                }
-                else {
-                    //printf("-->Write NOK!, Tried to write %d elements with total requesting size: %d .retOpt is %d\n", to_send, curr_sum + MSG_OH, retOpt);
-                    Common::Logger::globalInfo(Common::Logger::L1, "-->Write NOK");
-                }
-            }
-            
-            last_index += to_send;
-        }
-
-    }
-    catch(std::exception& e){
-        printf("Exception in read function\n");
-        Common::Logger::globalWarning(__PRETTY_FUNCTION__," Read invalid. Encountered Exception.");
-        //Common::Logger::globalError(e.what());
-    }
-}
-
-
 int S7200LibFacade::getByteSizeFromAddress(std::string S7200Address)
 {
     TS7DataItem item = S7200TS7DataItemFromAddress(S7200Address);
@@ -21,7 +21,15 @@
 #define OVERHEAD_READ_VARIABLE 5
 #define OVERHEAD_WRITE_MESSAGE 12
 #define OVERHEAD_WRITE_VARIABLE 16
-#define PDU_SIZE 240
+
+// Polling: requests, cached plans, quarantine and reconnection
+#define MAX_READ_ITEMS 19             // items in one read request
+#define PLAN_CACHE_SIZE 64            // due sets whose frames are kept
+#define LANE_LATENCY_PERIOD 10        // s, period of the lane latency metrics
+#define QUARANTINE_MIN_BACKOFF 10     // s, first retry of a quarantined address
+#define QUARANTINE_MAX_BACKOFF 600    // s
+#define MAX_READ_FAILURES 5           // failed read requests before a reconnection
+#define MAX_HELD_WRITES 1000          // writes held back by the limiter before only the last value of each address is kept
 
 #include <string>
 #include <chrono>
@@ -36,11 +44,35 @@
 #include <unordered_set>
 #include <condition_variable>
 #include <mutex>
+#include <atomic>
+#include <memory>
 #include "snap7.h"
+#include "Common/ConnectionSettings.hxx"
+#include "S7200PollController.hxx"
+#include "S7200PollAddress.hxx"
+#include "S7200ReadPlanner.hxx"
+#include "S7200Snapshot.hxx"
+#include "S7200WriteBuffer.hxx"
+#include "S7200WriteLimiter.hxx"
 
+/**
+ * @brief Value callbacks: the payload is allocated with new[] by the facade and
+ * the consumer owns it from then on (it frees it or hands it over to the DP)
+ */
 using consumeCallbackConsumer = std::function<void(const std::string& ip, const std::string& var, const std::string& pollTime, char* payload)>;
 using errorCallbackConsumer = std::function<void(const std::string& ip, int error,  const std::string& reason)>;
 
+/**
+ * @brief One value of a batch, see the value callbacks for the payload
+ */
+struct S7200BatchValue
+{
+    std::string var;
+    std::string pollTime;
+    char* payload;
+};
+using batchCallbackConsumer = std::function<void(const std::string& ip, std::vector<S7200BatchValue>& values, bool invalid)>;
+
 /**
  * @brief The S7200LibFacade class is a facade and encompasses all the consumer interaction with snap7
  */
@@ -51,18 +83,36 @@ public:
     /**
      * @brief S7200LibFacade constructor
      * @param ip : the ip
+     * @param settings : the settings of the link to this PLC
      * @param consumeCallbackConsumer : a callback that will be called for eached polled message
+     * @param batchCallbackConsumer : a callback that will be called with the values invalidated (connection lost)
+     * or valid again (first good read) together
      * */
-    S7200LibFacade(const std::string& ip, consumeCallbackConsumer, errorCallbackConsumer);
+    S7200LibFacade(const std::string& ip, const Common::ConnectionSettings& settings, consumeCallbackConsumer, errorCallbackConsumer,
+                   batchCallbackConsumer = nullptr);
     void Disconnect();
 
+    ~S7200LibFacade();
+
     S7200LibFacade(const S7200LibFacade&) = delete;
     S7200LibFacade& operator=(const S7200LibFacade&) = delete;
 
     bool isInitialized(){return _initialized;}
-    void Poll(std::vector<std::pair<std::string, int>>&, std::chrono::time_point<std::chrono::steady_clock> loopStartTime);
-    void write(std::vector<std::pair<std::string, void * >>);
+    // Replace the polled addresses, compiled by the next poll
+    void setAddresses(std::vector<S7200PollAddress>&& vars);
+    bool hasAddresses() const {return !_tableSource.empty();}
+    void Poll(std::chrono::time_point<std::chrono::steady_clock> loopStartTime);
+    void write(S7200WriteBuffer& writes);
     void clearLastWriteTimeList();
+    // Stop sending requests (driver stop): the request in progress ends within the snap7 timeouts
+    static void cancelAll(bool cancelled) {_cancelled = cancelled;}
+    /**
+     * @brief Watchdog (S7200Watchdog thread): close the connection if the snap7 call in progress is late
+     * @return true if the call exceeded the deadline of the PLC
+     * */
+    bool checkDeadline(std::chrono::time_point<std::chrono::steady_clock> now);
+    // Hand the last values over to the warm-start snapshot
+    void saveSnapshot();
     void Connect();
     void Reconnect();
 
@@ -71,37 +121,182 @@ public:
     // TS7DataItem* S7200LibFacade::S7200Read2(std::string S7200Address1, void* val1, std::string S7200Address2, void* val2);
     void S7200ReadN(std::vector<std::string> validVars, int N);
     void S7200ReadMaxN(std::vector <std::string> validVars, int N, int pdu_size, int VAR_OH, int MSG_OH);
-    void S7200ReadWriteMaxN(std::vector <std::pair<std::string, void *>> validVars, uint N, int PDU_SZ, int VAR_OH, int MSG_OH, int rorw);
     TS7DataItem S7200Write(std::string S7200Address, void* val);
     static int getByteSizeFromAddress(std::string S7200Address);
-    std::map<std::string, std::chrono::time_point<std::chrono::steady_clock> > lastWritePerAddress;
-    void S7200MarkDeviceConnectionError(std::string, bool);
+    void S7200MarkDeviceConnectionError(const std::string&, bool);
+    // Connection lost: the last value of every address is sent invalid, in one batch
+    void invalidateValues();
     static TS7DataItem S7200TS7DataItemFromAddress(std::string S7200Address);
 
-    void markForNextRead(std::vector<std::pair<std::string, void *>> addresses, std::chrono::time_point<std::chrono::steady_clock> loopFirstStartTime);
+    void markForNextRead(const S7200WriteBuffer& writes, std::chrono::time_point<std::chrono::steady_clock> loopFirstStartTime);
     
     static bool S7200AddressIsValid(std::string S7200Address);
     static int S7200AddressGetWordLen(std::string S7200Address);
     static int S7200AddressGetAmount(std::string S7200Address);
+    static bool S7200AddressIsS7String(std::string S7200Address);
+    static bool S7200AddressIsArray(std::string S7200Address);
 
     int readFailures = 0; //allowed since C++11
-    std::map <std::string, TS7DataItem> VarItems;
+    // Too many failed reads, or the keepalive probe got no answer
+    bool needsReconnect() const {return readFailures > MAX_READ_FAILURES || _linkDown;}
 
 
 private:
+    static std::atomic<bool> _cancelled;
     //std::unique_ptr<Consumer> _consumer;
     std::string _ip;
+    Common::ConnectionSettings _settings;
+    unsigned _settingsGeneration;
 
     consumeCallbackConsumer _consumeCB;
     errorCallbackConsumer _errorCB;
+    batchCallbackConsumer _batchCB;
+    // values read again since the connection loss, sent together once every value invalidated is read again
+    std::vector<S7200BatchValue> _revalidated;
     bool _initialized{false};
-    TS7Client *_client;
+    std::unique_ptr<TS7Client> _client;
+
+    // Keepalive: an idle link is probed with a 1 byte read, a dead link is reconnected before the next read
+    std::chrono::time_point<std::chrono::steady_clock> _lastAnswer;
+    std::atomic<bool> _linkDown{false};
+
+    // Scan time of the PLC, read from the start information of OB1 (SZL 0x0222) and published on <IP>$_ScanTime
+    std::unique_ptr<TS7SZL> _szl;
+    std::chrono::time_point<std::chrono::steady_clock> _lastScanTimeRead;
+    bool _scanTimeSupported{true};
+    int _publishedScanTime{-1};
+    int _publishedScanTimeMax{-1};
+
+    // Watchdog: start of the snap7 call in progress (steady clock, ns, 0 = none), checked by the S7200Watchdog thread
+    std::atomic<int64_t> _callStart{0};
+    std::atomic<int> _callDeadline{0}; // ms
+    std::atomic<bool> _callLate{false};
+    int _watchdogEvents{0}; // watchdog thread only
+    std::mutex _clientMutex; // _client replaced by a reconnection while the watchdog closes it, guards _callStart and _callLate
+
+    /**
+     * @brief Marks a snap7 call in progress for the watchdog, the call is watched if the PLC has a deadline
+     */
+    struct TrackedCall
+    {
+        S7200LibFacade& facade;
+        bool watched;
+        TrackedCall(S7200LibFacade& f);
+        ~TrackedCall();
+    };
+
+    // Adaptive polling: load of the link measured over each cycle
+    S7200PollController _controller;
+    S7200ReadPlanner _readPlanner;
+    S7200ReadPlanner _writePlanner;
+    int _publishedRate{-1};
+    std::chrono::time_point<std::chrono::steady_clock> _lastCycleStart;
+    std::chrono::steady_clock::duration _busyTime;
+    std::chrono::time_point<std::chrono::steady_clock> _pollStart;
+
+    // Per lane latency metrics, published on <IP>$_LatencyCritical/_LatencyNormal/_LatencyBulk
+    std::chrono::steady_clock::duration _laneLatency[S7200_LANE_COUNT] = {};
+    int _publishedLatency[S7200_LANE_COUNT] = {-1, -1, -1};
+    std::chrono::time_point<std::chrono::steady_clock> _latencyWindowStart;
+
+    /**
+     * @brief One polled address of the PLC, compiled once: its TS7DataItem reads into its own buffer
+     */
+    struct CompiledAddress
+    {
+        S7200PollAddress address;
+        bool valid{false};
+        TS7DataItem item;
+        int size{0};
+        std::vector<char> buffer;
+        bool polled{false};
+        std::chrono::time_point<std::chrono::steady_clock> lastRead;
+        // restored when the address is left out by the frame limit
+        bool previouslyPolled{false};
+        std::chrono::time_point<std::chrono::steady_clock> previousRead;
+        // Mirror mode: a V address is decoded from the block (span) covering it,
+        // a span delivers the addresses it covers instead of its own value
+        int storeSlot{-1};      // slot in the shared value store
+        int64_t timestamp{0};   // of the last value, ns since the Unix epoch
+        // An address refused by the PLC is quarantined: left out of the frames, read alone with a growing delay
+        bool quarantined{false};
+        int backoff{0}; // s
+        std::chrono::time_point<std::chrono::steady_clock> retryAt;
+        bool invalid{false}; // last value sent invalid, until its value read again is sent
+        int revalidation{-1}; // index in _revalidated while its value read again waits for the others
+        bool mirrored{false};
+        uint span{0};
+        std::vector<uint> members;
+
+        CompiledAddress(const S7200PollAddress& a) : address(a) {}
+    };
+
+    /**
+     * @brief The frames of a due set, ready to be sent
+     */
+    struct CachedPlan
+    {
+        std::vector<std::vector<TS7DataItem>> frames;
+        std::vector<std::vector<uint>> entries; // table index of each item of the frames
+        std::map<uint, uint> chunks;            // number of chunks of the addresses split over several items
+    };
+
+    std::vector<CompiledAddress> _table;
+    std::vector<S7200PollAddress> _tableSource;
+    bool _tableChanged{false};
+    int _fastPeriod{0};
+    std::vector<uint64_t> _due;
+    std::map<std::vector<uint64_t>, CachedPlan> _planCache;
+    int _planPduSize{0};
+    bool _tableMirror{false};
+    int _tableGap{0};
+    std::vector<int> _itemErrors;
+    int _quarantined{0};
+    int _publishedQuarantined{-1};
+    // warm start: values of the snapshot not matched to an address yet
+    bool _warmStart{true};
+    S7200Snapshot::Plc _warmValues;
+    std::chrono::time_point<std::chrono::steady_clock> _lastSnapshot;
+
+    // Write requests, kept between the cycles
+    S7200WriteLimiter _writeLimiter;
+    std::vector<uint> _writeIndex;  // index in the buffer of each item
+    std::vector<bool> _writeSent;
+    int _publishedThrottled{0};
+    int _writesDropped{0};  // held back, then replaced by a newer value of the same address
+    std::vector<TS7DataItem> _writeItems;
+    std::vector<S7200ReadPlanner::Item> _writeSizes;
+    std::vector<TS7DataItem> _frameItems;
+
+    void setConnectionParams();
+    int getPduSize();
+    void publishStatus(const std::string& var, int16_t value);
+    void keepAlive(std::chrono::time_point<std::chrono::steady_clock> now);
+    void monitorScanTime(std::chrono::time_point<std::chrono::steady_clock> now);
+    void resetClient();
+    void openConnection();
+    void publishLaneLatencies(std::chrono::time_point<std::chrono::steady_clock> now);
+    void restoreSnapshot();
+    void compileTable();
+    const CachedPlan& planFor(const std::vector<uint64_t>& due);
+    void compileMirror();
+    int periodOf(const CompiledAddress& entry);
+    std::vector<TS7DataItem> chunkItem(const CompiledAddress& entry, int pduSize) const;
+    uint readDue(const CachedPlan& plan, std::chrono::time_point<std::chrono::steady_clock> loopStartTime);
+    int readItems(TS7DataItem* items, int count, int* errors);
+    static bool isTransportError(int error);
+    void deliver(uint index, std::chrono::time_point<std::chrono::steady_clock> loopStartTime, int64_t timestamp);
+    void deliverMirror(const CompiledAddress& span, std::chrono::time_point<std::chrono::steady_clock> loopStartTime, int64_t timestamp);
+    void send(CompiledAddress& entry, char* payload);
+    void flushRevalidated();
+    void quarantine(uint index, int error);
+    void retryQuarantined(std::chrono::time_point<std::chrono::steady_clock> loopStartTime);
+    void sendWrites(S7200WriteBuffer& writes, bool critical);
     static int S7200AddressGetStart(std::string S7200Address);
     static int S7200AddressGetArea(std::string S7200Address);
     static int S7200AddressGetBit(std::string S7200Address);
     static int S7200DataSizeByte(int WordLength);
     static void S7200DisplayTS7DataItem(PS7DataItem item);
-    TS7DataItem initializeIfMissVar(std::string);
 
 };
 
@@ -0,0 +1,183 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#include "S7200PlcSession.hxx"
+#include "Common/Logger.hxx"
+
+#include <algorithm>
+
+S7200PlcSession::S7200PlcSession(const std::string& ip, const Common::ConnectionSettings& settings, consumeCallbackConsumer consumeCB, errorCallbackConsumer errorCB,
+                                 batchCallbackConsumer batchCB)
+    : _ip(ip), _facade(ip, settings, consumeCB, errorCB, batchCB)
+{
+}
+
+void S7200PlcSession::start(std::function<void()> poll)
+{
+    _thread = std::thread(poll);
+}
+
+void S7200PlcSession::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _running = false;
+    }
+    _cv.notify_all();
+}
+
+bool S7200PlcSession::wait(std::chrono::steady_clock::duration duration)
+{
+    std::unique_lock<std::mutex> lock{_mutex};
+    _cv.wait_for(lock, duration, [this]{ return !_running; });
+    return _running;
+}
+
+void S7200PlcSession::join()
+{
+    if(_thread.joinable())
+        _thread.join();
+}
+
+void S7200PlcSession::setAddresses(const std::vector<S7200PollAddress>& addresses)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    _addresses = addresses;
+    _addressGeneration++;
+}
+
+void S7200PlcSession::addAddress(const S7200PollAddress& address)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    if(std::find(_addresses.begin(), _addresses.end(), address) != _addresses.end())
+        return;
+    _addresses.push_back(address);
+    _addressGeneration++;
+}
+
+void S7200PlcSession::removeAddress(const S7200PollAddress& address)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    auto found = std::find(_addresses.begin(), _addresses.end(), address);
+    if(found == _addresses.end())
+        return;
+    _addresses.erase(found);
+    _addressGeneration++;
+}
+
+bool S7200PlcSession::takeAddresses(std::vector<S7200PollAddress>& addresses, unsigned& generation)
+{
+    // nothing to lock when nothing changed, the common case
+    if(_addressGeneration == generation)
+        return false;
+    std::lock_guard<std::mutex> lock{_mutex};
+    addresses = _addresses;
+    generation = _addressGeneration;
+    return true;
+}
+
+bool S7200PlcSession::pushWrite(const std::string& var, S7200WriteBuffer::Kind kind, const char* value, size_t length, bool critical)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    auto found = _targets.find(var);
+    if(found == _targets.end()) {
+        S7200WriteBuffer::Target target;
+        target.var = var;
+        target.item = S7200LibFacade::S7200TS7DataItemFromAddress(var);
+        delete[] static_cast<char*>(target.item.pdata);
+        target.item.pdata = NULL;
+        target.size = S7200LibFacade::getByteSizeFromAddress(var);
+        found = _targets.insert(std::make_pair(var, target)).first;
+    }
+    return _writes.push(found->second, kind, value, length, critical);
+}
+
+void S7200PlcSession::takeWrites(S7200WriteBuffer& writes)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    if(writes.empty()) {
+        writes.swap(_writes);
+    } else {
+        // writes held back by the write limiter go first
+        writes.append(_writes);
+    }
+    _writes.clear();
+}
+
+//--------------------------------------------------------------------------------
+
+S7200SessionRegistry::S7200SessionRegistry()
+    : _sessions(std::make_shared<const Sessions>())
+{
+}
+
+std::shared_ptr<S7200PlcSession> S7200SessionRegistry::find(const std::string& ip) const
+{
+    std::shared_ptr<const Sessions> sessions = std::atomic_load(&_sessions);
+    auto found = sessions->find(ip);
+    if(found == sessions->end())
+        return std::shared_ptr<S7200PlcSession>();
+    return found->second;
+}
+
+bool S7200SessionRegistry::add(const std::shared_ptr<S7200PlcSession>& session)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    std::shared_ptr<const Sessions> sessions = std::atomic_load(&_sessions);
+    if(sessions->count(session->getIp()))
+        return false;
+
+    auto updated = std::make_shared<Sessions>(*sessions);
+    (*updated)[session->getIp()] = session;
+    std::atomic_store(&_sessions, std::shared_ptr<const Sessions>(updated));
+    return true;
+}
+
+void S7200SessionRegistry::reap()
+{
+    if(_finished == 0)
+        return;
+    _finished = 0;
+
+    std::shared_ptr<const Sessions> sessions = std::atomic_load(&_sessions);
+    std::vector<std::shared_ptr<S7200PlcSession>> finished;
+    for(const auto& session : *sessions) {
+        if(session.second->isFinished())
+            finished.push_back(session.second);
+    }
+    if(finished.empty())
+        return;
+
+    std::lock_guard<std::mutex> lock{_mutex};
+    auto updated = std::make_shared<Sessions>(*std::atomic_load(&_sessions));
+    for(const auto& session : finished) {
+        // the thread has left its polling loop, the join does not block
+        session->join();
+        updated->erase(session->getIp());
+        Common::Logger::globalInfo(Common::Logger::L1, __PRETTY_FUNCTION__, "Session closed for IP:", session->getIp().c_str());
+    }
+    std::atomic_store(&_sessions, std::shared_ptr<const Sessions>(updated));
+}
+
+void S7200SessionRegistry::stopAll()
+{
+    std::shared_ptr<const Sessions> sessions = std::atomic_load(&_sessions);
+    for(const auto& session : *sessions)
+        session.second->stop();
+    for(const auto& session : *sessions)
+        session.second->join();
+
+    std::lock_guard<std::mutex> lock{_mutex};
+    std::atomic_store(&_sessions, std::make_shared<const Sessions>());
+}
@@ -0,0 +1,150 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#ifndef S7200PLCSESSION_HXX
+#define S7200PLCSESSION_HXX
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <chrono>
+#include "S7200LibFacade.hxx"
+#include "S7200WriteBuffer.hxx"
+
+/**
+ * @brief The S7200PlcSession class holds everything about one polled PLC: its facade (and snap7 connection),
+ * its write queue and its polling thread
+ *
+ * A session is created by the main thread when a PLC gets its first address and is shared through the
+ * S7200SessionRegistry. The polling thread runs until stop() is called (the PLC lost its last address or
+ * the driver stops), then marks the session finished; the main thread joins it and drops it from the registry.
+ */
+class S7200PlcSession
+{
+public:
+    S7200PlcSession(const std::string& ip, const Common::ConnectionSettings& settings, consumeCallbackConsumer, errorCallbackConsumer,
+                    batchCallbackConsumer = nullptr);
+
+    S7200PlcSession(const S7200PlcSession&) = delete;
+    S7200PlcSession& operator=(const S7200PlcSession&) = delete;
+
+    const std::string& getIp() const {return _ip;}
+    S7200LibFacade& getFacade() {return _facade;}
+
+    // Start the polling thread
+    void start(std::function<void()> poll);
+
+    // Ask the polling thread to stop, its waits end immediately
+    void stop();
+    bool isRunning() const {return _running;}
+
+    /**
+     * @brief Wait, unless the session is stopped
+     * @return false if the session is stopped
+     * */
+    bool wait(std::chrono::steady_clock::duration duration);
+
+    // Polled addresses (main thread): the initial list of the PLC, then the address events of the mapper
+    void setAddresses(const std::vector<S7200PollAddress>& addresses);
+    void addAddress(const S7200PollAddress& address);
+    void removeAddress(const S7200PollAddress& address);
+
+    /**
+     * @brief Copy the polled addresses if they changed since the given generation (polling thread)
+     * @param addresses : the polled addresses, unchanged if the generation is the current one
+     * @param generation : the generation of the last copy, updated
+     * @return false if the addresses did not change
+     * */
+    bool takeAddresses(std::vector<S7200PollAddress>& addresses, unsigned& generation);
+
+    // Called by the polling thread when it leaves
+    void finish() {_finished = true;}
+    bool isFinished() const {return _finished;}
+    void join();
+
+    /**
+     * @brief Queue a write (main thread), encoded for the PLC right away
+     * @param var : the address
+     * @param kind : interpretation of the value
+     * @param value : the value given by the transformation
+     * @param length : its size
+     * @param critical : not held back by the write limiter
+     * @return false if the value cannot be written to this address
+     * */
+    bool pushWrite(const std::string& var, S7200WriteBuffer::Kind kind, const char* value, size_t length, bool critical = false);
+    // Take the queued writes (polling thread), after the writes held back in the buffer given
+    void takeWrites(S7200WriteBuffer& writes);
+
+private:
+    std::string _ip;
+    S7200LibFacade _facade;
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::atomic<bool> _running{true};
+    std::atomic<bool> _finished{false};
+    S7200WriteBuffer _writes;
+    std::vector<S7200PollAddress> _addresses;
+    std::atomic<unsigned> _addressGeneration{0};
+    // compiled once per address, never removed: the queued writes point to them
+    std::unordered_map<std::string, S7200WriteBuffer::Target> _targets;
+    std::thread _thread;
+};
+
+/**
+ * @brief The S7200SessionRegistry class: the sessions by PLC address (IP or hostname)
+ *
+ * Lookups (every write from WinCC OA, every workProc) read an immutable map through an atomic shared_ptr
+ * and never lock; adding or removing a session copies the map under a mutex. A session removed from the
+ * registry is deleted when its last user releases it.
+ */
+class S7200SessionRegistry
+{
+public:
+    typedef std::map<std::string, std::shared_ptr<S7200PlcSession>> Sessions;
+
+    S7200SessionRegistry();
+
+    std::shared_ptr<S7200PlcSession> find(const std::string& ip) const;
+    std::shared_ptr<const Sessions> all() const {return std::atomic_load(&_sessions);}
+
+    /**
+     * @brief Register a session
+     * @return false if the PLC still has a session (e.g. not finished yet)
+     * */
+    bool add(const std::shared_ptr<S7200PlcSession>& session);
+
+    // Called by a polling thread once its session is finished
+    void notifyFinished() {_finished++;}
+
+    // Join the finished sessions and remove them, does nothing if no session finished
+    void reap();
+
+    // Stop all the sessions and wait for them
+    void stopAll();
+
+private:
+    std::mutex _mutex;
+    std::shared_ptr<const Sessions> _sessions;
+    std::atomic<unsigned> _finished{0};
+};
+
+#endif //S7200PLCSESSION_HXX
@@ -0,0 +1,74 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#ifndef S7200POLLADDRESS_HXX
+#define S7200POLLADDRESS_HXX
+
+#include <string>
+#include <strings.h>
+
+/**
+ * @brief Scheduling lane of an address: the critical reads go in the first requests of each cycle,
+ * the bulk reads only use the capacity left by the others
+ */
+enum class S7200Lane { Critical = 0, Normal = 1, Bulk = 2 };
+#define S7200_LANE_COUNT 3
+
+/**
+ * @brief One polled address of a PLC: <IP>$<VAR>$<POLLTIME>[$<LANE>]
+ */
+struct S7200PollAddress
+{
+    std::string var;
+    int pollTime;
+    S7200Lane lane;
+    std::string suffix; // end of the HW address after the var: "<POLLTIME>" or "<POLLTIME>$<LANE>"
+
+    S7200PollAddress() : pollTime(0), lane(S7200Lane::Normal) {}
+    S7200PollAddress(const std::string& v, const std::string& p, const std::string& l = "")
+        : var(v), pollTime(std::stoi(p)), lane(S7200Lane::Normal), suffix(l.empty() ? p : p + "$" + l)
+    {
+        parseLane(l, lane);
+    }
+
+    bool operator==(const S7200PollAddress& other) const {return var == other.var && suffix == other.suffix;}
+
+    /**
+     * @brief Lane from its name in the address (critical, normal or bulk)
+     * @return false if the name is unknown, lane is then left unchanged
+     * */
+    static bool parseLane(const std::string& name, S7200Lane& lane)
+    {
+        if(strcasecmp(name.c_str(), "critical") == 0)
+            lane = S7200Lane::Critical;
+        else if(strcasecmp(name.c_str(), "normal") == 0)
+            lane = S7200Lane::Normal;
+        else if(strcasecmp(name.c_str(), "bulk") == 0)
+            lane = S7200Lane::Bulk;
+        else
+            return false;
+        return true;
+    }
+
+    static const char* laneName(S7200Lane lane)
+    {
+        switch(lane){
+            case S7200Lane::Critical : return "Critical";
+            case S7200Lane::Bulk     : return "Bulk";
+            default                  : return "Normal";
+        }
+    }
+};
+
+#endif //S7200POLLADDRESS_HXX
@@ -0,0 +1,47 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#include "S7200PollController.hxx"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr double S7200PollController::MAX_STRETCH;
+constexpr double S7200PollController::HIGH_LOAD;
+constexpr double S7200PollController::LOW_LOAD;
+
+int S7200PollController::effectivePeriod(int period, bool fast) const
+{
+    if(fast || _stretch <= 1.0)
+        return period;
+    return (int) std::ceil(period * _stretch);
+}
+
+void S7200PollController::update(std::chrono::steady_clock::duration busy, std::chrono::steady_clock::duration cycle, bool lagging)
+{
+    if(cycle.count() <= 0)
+        return;
+
+    double load = std::chrono::duration<double>(busy).count() / std::chrono::duration<double>(cycle).count();
+
+    if(load > HIGH_LOAD || lagging || _plcOverloaded)
+        _stretch = std::min(_stretch * 1.5, MAX_STRETCH);
+    else if(load < LOW_LOAD)
+        _stretch = std::max(_stretch / 1.2, 1.0);
+}
+
+int S7200PollController::getRatePercent() const
+{
+    return (int) std::lround(100.0 / _stretch);
+}
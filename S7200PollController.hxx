@@ -0,0 +1,68 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#ifndef S7200POLLCONTROLLER_HXX
+#define S7200POLLCONTROLLER_HXX
+
+#include <chrono>
+
+/**
+ * @brief The S7200PollController class adapts the polling rate of one PLC to the measured load of its link
+ *
+ * At the end of every polling cycle the facade reports the time spent talking to the PLC. When the link is
+ * saturated (busy for most of the cycle, or addresses read later than their deadline) the periods of the slow
+ * addresses are stretched; they are tightened back once there is headroom again. A PLC whose scan time is over
+ * its ceiling stretches them too. Fast addresses always keep their configured period.
+ */
+class S7200PollController
+{
+public:
+    static constexpr double MAX_STRETCH = 8.0;
+    static constexpr double HIGH_LOAD = 0.8;
+    static constexpr double LOW_LOAD = 0.5;
+
+    /**
+     * @brief Period to use for an address
+     * @param period : the configured period (s)
+     * @param fast : fast addresses are never stretched
+     * */
+    int effectivePeriod(int period, bool fast) const;
+
+    /**
+     * @brief Report the end of a polling cycle
+     * @param busy : time spent in requests to the PLC during the cycle
+     * @param cycle : time since the start of the previous cycle
+     * @param lagging : true if some addresses were read later than their period
+     * */
+    void update(std::chrono::steady_clock::duration busy, std::chrono::steady_clock::duration cycle, bool lagging);
+
+    /**
+     * @brief Effective rate of the slow addresses, in percent of their configured rate
+     * */
+    int getRatePercent() const;
+
+    double getStretch() const {return _stretch;}
+
+    /**
+     * @brief Report the scan time of the PLC against its ceiling: while it is over, the slow addresses are stretched
+     * as for a saturated link
+     * */
+    void setPlcOverloaded(bool overloaded) {_plcOverloaded = overloaded;}
+
+private:
+    double _stretch{1.0};
+    bool _plcOverloaded{false};
+};
+
+#endif //S7200POLLCONTROLLER_HXX
@@ -0,0 +1,153 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#include "S7200ReadPlanner.hxx"
+
+#include <algorithm>
+#include <stdint.h>
+
+const S7200ReadPlanner::Plan& S7200ReadPlanner::plan(const std::vector<Item>& items, int pduSize, int varOverhead, int msgOverhead, uint maxItems, bool keepOrder)
+{
+    if(_valid && items == _items && pduSize == _pduSize && varOverhead == _varOverhead && msgOverhead == _msgOverhead &&
+       maxItems == _maxItems && keepOrder == _keepOrder)
+        return _plan;
+
+    _items = items;
+    _pduSize = pduSize;
+    _varOverhead = varOverhead;
+    _msgOverhead = msgOverhead;
+    _maxItems = maxItems > 0 ? maxItems : 1;
+    _keepOrder = keepOrder;
+    // a frame holds strictly less than the PDU minus the message overhead
+    _capacity = pduSize - msgOverhead - 1;
+
+    if(keepOrder) {
+        _plan = nextFit(items);
+    } else {
+        _plan = firstFitDecreasing(items);
+        Plan best;
+        if(exact(items, best) && best.size() < _plan.size())
+            _plan = best;
+    }
+
+    _valid = true;
+    _computed++;
+    return _plan;
+}
+
+S7200ReadPlanner::Plan S7200ReadPlanner::nextFit(const std::vector<Item>& items) const
+{
+    Plan plan;
+    int fill = 0;
+    for(uint i = 0; i < items.size(); i++) {
+        if(plan.empty() || oversized(items[i]) || fill + cost(items[i]) > _capacity || plan.back().size() >= _maxItems ||
+           oversized(items[plan.back().front()])) {
+            plan.push_back(std::vector<uint>());
+            fill = 0;
+        }
+        plan.back().push_back(i);
+        fill += cost(items[i]);
+    }
+    return plan;
+}
+
+S7200ReadPlanner::Plan S7200ReadPlanner::firstFitDecreasing(const std::vector<Item>& items) const
+{
+    std::vector<uint> order(items.size());
+    for(uint i = 0; i < order.size(); i++)
+        order[i] = i;
+    // lane by lane, biggest first
+    std::stable_sort(order.begin(), order.end(), [&](uint a, uint b) {
+        if(items[a].lane != items[b].lane)
+            return items[a].lane < items[b].lane;
+        return items[a].size > items[b].size;
+    });
+
+    Plan plan;
+    std::vector<int> fills;
+    for(uint i : order) {
+        uint frame = plan.size();
+        if(!oversized(items[i])) {
+            for(uint f = 0; f < plan.size(); f++) {
+                if(fills[f] + cost(items[i]) <= _capacity && plan[f].size() < _maxItems) {
+                    frame = f;
+                    break;
+                }
+            }
+        }
+
+        if(frame == plan.size()) {
+            plan.push_back(std::vector<uint>());
+            // nothing is added next to an oversized item
+            fills.push_back(oversized(items[i]) ? _capacity + 1 : 0);
+        }
+        plan[frame].push_back(i);
+        fills[frame] += cost(items[i]);
+    }
+    return plan;
+}
+
+bool S7200ReadPlanner::exact(const std::vector<Item>& items, Plan& plan) const
+{
+    // Subset search: for every set of placed items, the fewest frames and then the least filled last frame.
+    // The item count per frame never limits a set smaller than maxItems.
+    uint n = items.size();
+    if(n < 2 || n > EXACT_LIMIT || n > _maxItems)
+        return false;
+    for(const auto& item : items) {
+        if(oversized(item) || item.lane != items[0].lane)
+            return false;
+    }
+
+    struct State { int frames; int fill; int last; };
+    std::vector<State> best(1u << n, State{INT32_MAX, 0, -1});
+    best[0] = State{1, 0, -1};
+    for(uint mask = 0; mask < best.size(); mask++) {
+        if(best[mask].frames == INT32_MAX)
+            continue;
+        for(uint j = 0; j < n; j++) {
+            if(mask & (1u << j))
+                continue;
+            State next = best[mask];
+            if(next.fill + cost(items[j]) <= _capacity) {
+                next.fill += cost(items[j]);
+            } else {
+                next.frames++;
+                next.fill = cost(items[j]);
+            }
+            next.last = j;
+            State& current = best[mask | (1u << j)];
+            if(next.frames < current.frames || (next.frames == current.frames && next.fill < current.fill))
+                current = next;
+        }
+    }
+
+    // replay the placement order
+    std::vector<uint> order;
+    for(uint mask = best.size() - 1; mask != 0; mask &= ~(1u << best[mask].last))
+        order.push_back(best[mask].last);
+    std::reverse(order.begin(), order.end());
+
+    plan.clear();
+    int fill = 0;
+    for(uint i : order) {
+        if(plan.empty() || fill + cost(items[i]) > _capacity) {
+            plan.push_back(std::vector<uint>());
+            fill = 0;
+        }
+        plan.back().push_back(i);
+        fill += cost(items[i]);
+    }
+    return true;
+}
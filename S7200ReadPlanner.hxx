@@ -0,0 +1,76 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#ifndef S7200READPLANNER_HXX
+#define S7200READPLANNER_HXX
+
+#include <vector>
+#include <sys/types.h>
+
+/**
+ * @brief The S7200ReadPlanner class groups the items of a polling cycle into as few requests (frames) as possible
+ *
+ * Every frame must fit in the PDU: the sum of the item sizes plus OVERHEAD_READ_VARIABLE per item, plus
+ * OVERHEAD_READ_MESSAGE, and at most maxItems items. Items are packed first-fit-decreasing lane by lane, so the
+ * frames holding critical items come first and the bulk items fill the room left by the others. Small single lane
+ * sets are packed optimally. An item bigger than a frame is alone in its frame.
+ *
+ * The plan only depends on the item sizes and lanes: it is kept until they change.
+ */
+class S7200ReadPlanner
+{
+public:
+    struct Item
+    {
+        int size;   // bytes
+        int lane;   // S7200Lane, lower first
+        bool operator==(const Item& other) const {return size == other.size && lane == other.lane;}
+    };
+
+    typedef std::vector<std::vector<uint>> Plan; // frames of item indices
+
+    // Sets up to this size are packed with an exact search
+    static const uint EXACT_LIMIT = 12;
+
+    /**
+     * @brief Frames for a set of items
+     * @param keepOrder : fill the frames in the order of the items (writes to the same address must keep their order)
+     * */
+    const Plan& plan(const std::vector<Item>& items, int pduSize, int varOverhead, int msgOverhead, uint maxItems, bool keepOrder);
+
+    // Number of plans computed, the other calls used the cached plan
+    unsigned long getComputed() const {return _computed;}
+
+private:
+    Plan nextFit(const std::vector<Item>& items) const;
+    Plan firstFitDecreasing(const std::vector<Item>& items) const;
+    bool exact(const std::vector<Item>& items, Plan& plan) const;
+    int cost(const Item& item) const {return item.size + _varOverhead;}
+    bool oversized(const Item& item) const {return cost(item) > _capacity;}
+
+    int _capacity{0};
+    int _varOverhead{0};
+    uint _maxItems{0};
+
+    // cache
+    std::vector<Item> _items;
+    int _pduSize{0};
+    int _msgOverhead{0};
+    bool _keepOrder{false};
+    bool _valid{false};
+    Plan _plan;
+    unsigned long _computed{0};
+};
+
+#endif //S7200READPLANNER_HXX
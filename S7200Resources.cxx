@@ -18,12 +18,17 @@
 #include "S7200Resources.hxx"
 #include "Common/Logger.hxx"
 #include "Common/Constants.hxx"
+#include "Common/ConnectionSettings.hxx"
 #include <ErrHdl.hxx>
+#include <strings.h>
 
 const CharString S7200Resources::SECTION_NAME = "s7200";
 const CharString S7200Resources::TSAP_PORT_LOCAL = "localTSAP";
 const CharString S7200Resources::TSAP_PORT_REMOTE = "remoteTSAP";
 const CharString S7200Resources::POLLING_INTERVAL = "pollingInterval";
+const CharString S7200Resources::STANDBY_POLLING_INTERVAL = "standbyPollingInterval";
+const CharString S7200Resources::VALUE_STORE_SLOTS = "valueStoreSlots";
+const CharString S7200Resources::SNAPSHOT_INTERVAL = "snapshotInterval";
 const CharString S7200Resources::MEASUREMENT_PATH = "mesFile";
 const CharString S7200Resources::EVENT_PATH = "eventFile";
 const CharString S7200Resources::USERFILE_PATH = "userFile";
@@ -51,9 +56,27 @@ void S7200Resources::init(int &argc, char *argv[])
 
 //-------------------------------------------------------------------------------
 
+bool S7200Resources::isPlcSection(std::string& ip) {
+	if (cfgState != CFG_SECT_START)
+		return false;
+
+	std::string name(keyWord.c_str());
+	if (!name.empty() && name.front() == '[')
+		name = name.substr(1, name.find(']') - 1);
+
+	std::string prefix = std::string(SECTION_NAME.c_str()) + ".";
+	if (name.size() <= prefix.size() || strncasecmp(name.c_str(), prefix.c_str(), prefix.size()) != 0)
+		return false;
+
+	ip = name.substr(prefix.size());
+	return true;
+}
+
 PVSSboolean S7200Resources::readSection() {
-	// Are we in our section ? This is true for "remus_drv" or "remus_drv_<num>"
-	if (!isSection(SECTION_NAME))
+	// Are we in our section ? This is true for "s7200", or "s7200.<ip>" for the settings of one PLC
+	std::string plcIp;
+	bool plcSection = isPlcSection(plcIp);
+	if (!plcSection && !isSection(SECTION_NAME))
 		return PVSS_FALSE;
 
 	// skip "[remus_drv_<num>]"
@@ -65,15 +88,31 @@ PVSSboolean S7200Resources::readSection() {
 		// Now read the section until new section or end of file
 		while ((cfgState != CFG_SECT_START) && (cfgState != CFG_EOF)) {
 			// Test the keywords
-			if (keyWord.startsWith(TSAP_PORT_LOCAL)) {
+			if (plcSection) {
+				cfgStream >> tmpStr;
+				if (!Common::ConnectionSettings::setOverride(plcIp, keyWord.c_str(), tmpStr))
+					Common::Logger::globalWarning("Unknown key word in section for PLC", plcIp.c_str(), keyWord.c_str());
+			}else if (keyWord.startsWith(TSAP_PORT_LOCAL)) {
 				cfgStream >> tmpStr;
 				Common::Constants::setLocalTsapPort(strtol(tmpStr.c_str(), NULL, 16));
+				Common::ConnectionSettings::setDefault(TSAP_PORT_LOCAL.c_str(), tmpStr);
 			}else if(keyWord.startsWith(TSAP_PORT_REMOTE)) {
 				cfgStream >> tmpStr;
 				Common::Constants::setRemoteTsapPort(strtol(tmpStr.c_str(), NULL, 16));
+				Common::ConnectionSettings::setDefault(TSAP_PORT_REMOTE.c_str(), tmpStr);
 			}else if(keyWord.startsWith(POLLING_INTERVAL)) {
 				cfgStream >> tmpStr;
 				Common::Constants::setPollingInterval(atoi(tmpStr.c_str()));
+				Common::ConnectionSettings::setDefault(POLLING_INTERVAL.c_str(), tmpStr);
+			}else if(keyWord.startsWith(STANDBY_POLLING_INTERVAL)) {
+				cfgStream >> tmpStr;
+				Common::Constants::setStandbyPollingInterval(atoi(tmpStr.c_str()));
+			}else if(keyWord.startsWith(VALUE_STORE_SLOTS)) {
+				cfgStream >> tmpStr;
+				Common::Constants::setValueStoreSlots(atoi(tmpStr.c_str()));
+			}else if(keyWord.startsWith(SNAPSHOT_INTERVAL)) {
+				cfgStream >> tmpStr;
+				Common::Constants::setSnapshotInterval(atoi(tmpStr.c_str()));
       		}else if(keyWord.startsWith(MEASUREMENT_PATH)) {
 				cfgStream >> tmpStr;
 				Common::Constants::setMeasFilePath(tmpStr);
@@ -83,7 +122,11 @@ PVSSboolean S7200Resources::readSection() {
       		}else if(keyWord.startsWith(USERFILE_PATH)) {
 				cfgStream >> tmpStr;
 				Common::Constants::setUserFilePath(tmpStr);
-      		}
+      		}else {
+				cfgStream >> tmpStr;
+				if (!Common::ConnectionSettings::setDefault(keyWord.c_str(), tmpStr))
+					Common::Logger::globalWarning("Unknown key word in section", keyWord.c_str());
+			}
 
 			getNextEntry();
 		}
@@ -21,6 +21,7 @@
 //  - Be an interface to internal datapoints
 
 #include <DrvRsrce.hxx>
+#include <string>
 
 class S7200Resources : public DrvRsrce
 {
@@ -40,10 +41,16 @@ class S7200Resources : public DrvRsrce
   private:
     S7200Resources(){}
 
+    // true if the current section is a PLC specific one, e.g. [s7200.172.18.130.170]
+    static bool isPlcSection(std::string& ip);
+
     static const CharString SECTION_NAME;
     static const CharString TSAP_PORT_LOCAL;
     static const CharString TSAP_PORT_REMOTE;
     static const CharString POLLING_INTERVAL;
+    static const CharString STANDBY_POLLING_INTERVAL;
+    static const CharString VALUE_STORE_SLOTS;
+    static const CharString SNAPSHOT_INTERVAL;
     static const CharString MEASUREMENT_PATH;
     static const CharString EVENT_PATH;
     static const CharString USERFILE_PATH;
@@ -0,0 +1,201 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#include "S7200Snapshot.hxx"
+#include "Common/Logger.hxx"
+
+#include <fstream>
+#include <set>
+#include <cstdio>
+
+namespace
+{
+    const char MAGIC[8] = "S7200SN";
+
+    template<typename T> void put(std::ostream& out, T value) {out.write(reinterpret_cast<const char*>(&value), sizeof(T));}
+    template<typename T> bool get(std::istream& in, T& value) {return (bool) in.read(reinterpret_cast<char*>(&value), sizeof(T));}
+
+    void putBytes(std::ostream& out, const char* data, uint32_t size)
+    {
+        put(out, size);
+        out.write(data, size);
+    }
+
+    bool getBytes(std::istream& in, std::vector<char>& data)
+    {
+        uint32_t size;
+        // a size beyond any PLC address means a corrupted file
+        if(!get(in, size) || size > 65536)
+            return false;
+        data.resize(size);
+        return (bool) in.read(data.data(), size);
+    }
+
+    bool getString(std::istream& in, std::string& value)
+    {
+        std::vector<char> data;
+        if(!getBytes(in, data))
+            return false;
+        value.assign(data.begin(), data.end());
+        return true;
+    }
+}
+
+S7200Snapshot& S7200Snapshot::getInstance()
+{
+    static S7200Snapshot instance;
+    return instance;
+}
+
+void S7200Snapshot::open(const std::string& path, size_t interval)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    _path = path;
+    _interval = interval;
+    _lastWrite = std::chrono::steady_clock::now();
+
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    uint32_t version, plcs;
+    if(!in || !in.read(magic, sizeof(magic)) || std::string(magic, sizeof(magic)) != std::string(MAGIC, sizeof(MAGIC)) ||
+       !get(in, version) || version != VERSION || !get(in, plcs)) {
+        Common::Logger::globalInfo(Common::Logger::L1, __PRETTY_FUNCTION__, "No usable snapshot in", path.c_str());
+        return;
+    }
+
+    std::map<std::string, Plc> loaded;
+    for(uint32_t p = 0; p < plcs; p++) {
+        std::string ip;
+        uint32_t count;
+        if(!getString(in, ip) || !get(in, count))
+            break;
+        Plc& plc = loaded[ip];
+        for(uint32_t i = 0; i < count; i++) {
+            std::string var;
+            Value value;
+            if(!getString(in, var) || !getString(in, value.suffix) || !get(in, value.timestamp) || !getBytes(in, value.value)) {
+                Common::Logger::globalWarning(__PRETTY_FUNCTION__, "Truncated snapshot, ignored:", path.c_str());
+                return;
+            }
+            plc[var] = std::move(value);
+        }
+    }
+    _loaded.swap(loaded);
+    Common::Logger::globalInfo(Common::Logger::L1, __PRETTY_FUNCTION__, "Snapshot loaded from", path.c_str());
+}
+
+bool S7200Snapshot::restore(const std::string& ip, Plc& plc)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    auto found = _loaded.find(ip);
+    if(found == _loaded.end())
+        return false;
+    plc.swap(found->second);
+    _loaded.erase(found);
+    return true;
+}
+
+void S7200Snapshot::prune(const std::map<std::string, std::vector<S7200PollAddress>>& configured)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    size_t pruned = 0;
+    for(auto plc = _loaded.begin(); plc != _loaded.end(); ) {
+        // address and polling suffix of the addresses of this PLC
+        std::set<std::pair<std::string, std::string>> addresses;
+        auto found = configured.find(plc->first);
+        if(found != configured.end()) {
+            for(const auto& address : found->second)
+                addresses.insert(std::make_pair(address.var, address.suffix));
+        }
+        for(auto value = plc->second.begin(); value != plc->second.end(); ) {
+            if(addresses.count(std::make_pair(value->first, value->second.suffix))) {
+                ++value;
+            } else {
+                value = plc->second.erase(value);
+                pruned++;
+            }
+        }
+        if(plc->second.empty())
+            plc = _loaded.erase(plc);
+        else
+            ++plc;
+    }
+    S7200_LOG_INFO(Common::Logger::L1, __PRETTY_FUNCTION__, " ", pruned, " values of addresses no longer configured dropped from the snapshot");
+}
+
+void S7200Snapshot::update(const std::string& ip, Plc&& plc)
+{
+    std::unique_lock<std::mutex> file{_fileMutex, std::try_to_lock};
+    std::map<std::string, Plc> plcs;
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _current[ip] = std::move(plc);
+        // another thread is writing the file: this state goes with the next write
+        if(!file.owns_lock() || std::chrono::steady_clock::now() - _lastWrite < std::chrono::seconds(_interval))
+            return;
+        _lastWrite = std::chrono::steady_clock::now();
+        plcs = collect();
+    }
+    write(plcs);
+}
+
+void S7200Snapshot::save()
+{
+    std::lock_guard<std::mutex> file{_fileMutex};
+    std::map<std::string, Plc> plcs;
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        if(_interval == 0)
+            return;
+        _lastWrite = std::chrono::steady_clock::now();
+        plcs = collect();
+    }
+    write(plcs);
+}
+
+std::map<std::string, S7200Snapshot::Plc> S7200Snapshot::collect() const
+{
+    std::map<std::string, Plc> plcs(_loaded);
+    for(const auto& plc : _current)
+        plcs[plc.first] = plc.second;
+    return plcs;
+}
+
+void S7200Snapshot::write(const std::map<std::string, Plc>& plcs) const
+{
+    // written next to the snapshot then renamed: a crash never leaves a half written snapshot
+    std::string tmp = _path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(MAGIC, sizeof(MAGIC));
+        put(out, VERSION);
+        put(out, (uint32_t) plcs.size());
+        for(const auto& plc : plcs) {
+            putBytes(out, plc.first.data(), plc.first.size());
+            put(out, (uint32_t) plc.second.size());
+            for(const auto& value : plc.second) {
+                putBytes(out, value.first.data(), value.first.size());
+                putBytes(out, value.second.suffix.data(), value.second.suffix.size());
+                put(out, value.second.timestamp);
+                putBytes(out, value.second.value.data(), value.second.value.size());
+            }
+        }
+        if(!out) {
+            Common::Logger::globalWarning(__PRETTY_FUNCTION__, "Cannot write the snapshot", tmp.c_str());
+            return;
+        }
+    }
+    if(std::rename(tmp.c_str(), _path.c_str()) != 0)
+        Common::Logger::globalWarning(__PRETTY_FUNCTION__, "Cannot replace the snapshot", _path.c_str());
+}
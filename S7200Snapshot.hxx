@@ -0,0 +1,94 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#ifndef S7200SNAPSHOT_HXX
+#define S7200SNAPSHOT_HXX
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <stdint.h>
+#include "S7200PollAddress.hxx"
+
+/**
+ * @brief Warm-start snapshot: the addresses of every PLC with their last raw value, kept on disk
+ *
+ * Each polling thread hands over the state of its PLC every snapshot interval; the file is
+ * rewritten at most once per interval and when the driver stops, outside of the state lock.
+ * At startup the file is loaded once and each PLC takes back the values of the addresses that still
+ * exist with the same polling suffix and size, the other entries are dropped. The PLCs that did not
+ * take their values back yet (not connected) keep them in the next files, once the values of the
+ * addresses no longer configured are pruned.
+ */
+class S7200Snapshot
+{
+public:
+    static const uint32_t VERSION = 1;
+
+    struct Value
+    {
+        std::string suffix;
+        int64_t timestamp;  // ns since the Unix epoch
+        std::vector<char> value;
+    };
+
+    typedef std::map<std::string, Value> Plc; // by address
+
+    static S7200Snapshot& getInstance();
+
+    /**
+     * @brief Load the snapshot of the previous run and enable the snapshots
+     * @param interval : seconds between two writes of the file
+     * */
+    void open(const std::string& path, size_t interval);
+
+    bool isEnabled() const {return _interval > 0;}
+
+    /**
+     * @brief Take the values of a PLC from the loaded snapshot (once per PLC)
+     * @return false if the snapshot has no values for this PLC
+     * */
+    bool restore(const std::string& ip, Plc& plc);
+
+    /**
+     * @brief Drop the loaded values of the PLCs and addresses no longer configured (main thread, once the addresses are known)
+     * @param configured : the polled addresses by PLC
+     * */
+    void prune(const std::map<std::string, std::vector<S7200PollAddress>>& configured);
+
+    // Replace the state of a PLC, the file is written if the interval has elapsed
+    void update(const std::string& ip, Plc&& plc);
+
+    // Write the file now
+    void save();
+
+private:
+    S7200Snapshot() = default;
+    // Loaded values not taken back yet, replaced by the current state of the PLCs (under _mutex)
+    std::map<std::string, Plc> collect() const;
+    void write(const std::map<std::string, Plc>& plcs) const;
+
+    std::mutex _mutex;
+    // held while the file is written, a polling thread never waits for it
+    std::mutex _fileMutex;
+    std::string _path;
+    size_t _interval{0};
+    std::map<std::string, Plc> _loaded;
+    std::map<std::string, Plc> _current;
+    std::chrono::time_point<std::chrono::steady_clock> _lastWrite;
+};
+
+#endif //S7200SNAPSHOT_HXX
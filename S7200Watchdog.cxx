@@ -0,0 +1,99 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#include "S7200Watchdog.hxx"
+#include "S7200LibFacade.hxx"
+
+#include <vector>
+#include <chrono>
+
+S7200Watchdog& S7200Watchdog::getInstance()
+{
+    static S7200Watchdog instance;
+    return instance;
+}
+
+S7200Watchdog::~S7200Watchdog()
+{
+    stop();
+}
+
+void S7200Watchdog::start()
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    if(_running)
+        return;
+
+    _running = true;
+    _thread = std::thread(&S7200Watchdog::run, this);
+}
+
+void S7200Watchdog::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        if(!_running)
+            return;
+        _running = false;
+    }
+    _cv.notify_one();
+
+    if(_thread.joinable())
+        _thread.join();
+}
+
+void S7200Watchdog::track(S7200LibFacade* facade)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    _calls.insert(facade);
+}
+
+void S7200Watchdog::untrack(S7200LibFacade* facade)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    _calls.erase(facade);
+}
+
+void S7200Watchdog::forget(S7200LibFacade* facade)
+{
+    std::lock_guard<std::mutex> check{_checkMutex};
+    untrack(facade);
+}
+
+void S7200Watchdog::run()
+{
+    std::vector<S7200LibFacade*> calls;
+    std::unique_lock<std::mutex> lock{_mutex};
+    while(_running)
+    {
+        _cv.wait_for(lock, std::chrono::milliseconds(WATCHDOG_PERIOD), [this]{ return !_running; });
+        if(_calls.empty())
+            continue;
+        lock.unlock();
+
+        {
+            // the facades copied cannot be deleted before the end of the check
+            std::lock_guard<std::mutex> check{_checkMutex};
+            {
+                std::lock_guard<std::mutex> copy{_mutex};
+                calls.assign(_calls.begin(), _calls.end());
+            }
+            auto now = std::chrono::steady_clock::now();
+            for(S7200LibFacade* facade : calls)
+                facade->checkDeadline(now);
+        }
+
+        lock.lock();
+    }
+}
@@ -0,0 +1,70 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#ifndef S7200WATCHDOG_HXX
+#define S7200WATCHDOG_HXX
+
+#include <set>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+// Period of the deadline checks (ms)
+#define WATCHDOG_PERIOD 100
+
+class S7200LibFacade;
+
+/**
+ * @brief Watchdog of the snap7 calls, on its own thread
+ *
+ * A facade registers itself for the duration of each snap7 call (when its PLC has a call deadline).
+ * Every WATCHDOG_PERIOD ms the watchdog thread checks the calls in progress, and only those: a late
+ * call gets its connection closed and is reported by the watchdog thread, the main thread never
+ * waits for it.
+ */
+class S7200Watchdog
+{
+public:
+    static S7200Watchdog& getInstance();
+
+    ~S7200Watchdog();
+
+    // Start and stop the watchdog thread
+    void start();
+    void stop();
+
+    // A snap7 call of the facade starts or ends (polling thread)
+    void track(S7200LibFacade* facade);
+    void untrack(S7200LibFacade* facade);
+
+    // The facade is being deleted: waits for the check in progress
+    void forget(S7200LibFacade* facade);
+
+private:
+    S7200Watchdog() {}
+    S7200Watchdog(S7200Watchdog const&) = delete;
+    void operator= (S7200Watchdog const&) = delete;
+
+    void run();
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _running{false};
+    std::set<S7200LibFacade*> _calls;
+    // held by the watchdog thread while it checks the calls
+    std::mutex _checkMutex;
+    std::thread _thread;
+};
+
+#endif //S7200WATCHDOG_HXX
@@ -0,0 +1,170 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#include "S7200WriteBuffer.hxx"
+
+#include <cstring>
+#include <cmath>
+#include <unordered_set>
+
+namespace {
+
+// Big endian signed, unsigned or floating point value of 1 to 8 bytes
+int64_t decodeInteger(const char* value, size_t length, bool isSigned)
+{
+    uint64_t raw = 0;
+    for(size_t i = 0; i < length; i++)
+        raw = (raw << 8) | (unsigned char) value[i];
+    if(isSigned && length < 8 && (value[0] & 0x80))
+        raw |= ~0ULL << (length * 8);
+    return (int64_t) raw;
+}
+
+double decodeFloat(const char* value, size_t length)
+{
+    uint64_t raw = (uint64_t) decodeInteger(value, length, false);
+    if(length == sizeof(float)) {
+        uint32_t raw32 = (uint32_t) raw;
+        float f;
+        std::memcpy(&f, &raw32, sizeof(f));
+        return f;
+    }
+    double d;
+    std::memcpy(&d, &raw, sizeof(d));
+    return d;
+}
+
+void encodeBigEndian(uint64_t raw, int size, char* out)
+{
+    for(int i = 0; i < size; i++)
+        out[i] = (char) (raw >> (8 * (size - 1 - i)));
+}
+
+}
+
+bool S7200WriteBuffer::push(const Target& target, Kind kind, const char* value, size_t length, bool critical)
+{
+    if(value == NULL || length == 0 || target.size <= 0)
+        return false;
+
+    size_t offset = _data.size();
+    _data.resize(offset + target.size);
+    if(!convert(target, kind, value, length, _data.data() + offset)) {
+        _data.resize(offset);
+        return false;
+    }
+    _writes.push_back(Write{&target, offset, critical});
+    return true;
+}
+
+bool S7200WriteBuffer::convert(const Target& target, Kind kind, const char* value, size_t length, char* out)
+{
+    // A bit is written as one byte, 0 or 1
+    if(target.item.WordLen == S7WLBit && target.item.Amount == 1) {
+        bool set = false;
+        for(size_t i = 0; i < length; i++)
+            set = set || value[i] != 0;
+        out[0] = set ? 1 : 0;
+        return true;
+    }
+
+    // Same width: the transformation already encoded the value for the PLC
+    if(length == (size_t) target.size) {
+        std::memcpy(out, value, length);
+        return true;
+    }
+
+    // Characters and blocks: as many bytes as the address holds, the rest padded with 0
+    if(kind == Kind::Raw || target.item.Amount != 1) {
+        size_t copied = length < (size_t) target.size ? length : target.size;
+        std::memcpy(out, value, copied);
+        std::memset(out + copied, 0, target.size - copied);
+        return true;
+    }
+
+    if(length > sizeof(uint64_t) || (kind == Kind::Float && length != sizeof(float) && length != sizeof(double)))
+        return false;
+
+    // One value of another width: VB takes 1 byte, VW an INT, VD a REAL for a floating point
+    // DPE and a DINT otherwise. Integers are truncated to the width of the address.
+    if(kind == Kind::Float) {
+        double d = decodeFloat(value, length);
+        if(target.item.WordLen == S7WLReal) {
+            float f = (float) d;
+            uint32_t raw;
+            std::memcpy(&raw, &f, sizeof(raw));
+            encodeBigEndian(raw, sizeof(raw), out);
+        } else {
+            encodeBigEndian((uint64_t) (int64_t) std::llround(d), target.size, out);
+        }
+    } else {
+        encodeBigEndian((uint64_t) decodeInteger(value, length, kind == Kind::Signed), target.size, out);
+    }
+    return true;
+}
+
+void S7200WriteBuffer::clear()
+{
+    _writes.clear();
+    _data.clear();
+}
+
+void S7200WriteBuffer::swap(S7200WriteBuffer& other)
+{
+    _writes.swap(other._writes);
+    _data.swap(other._data);
+}
+
+void S7200WriteBuffer::append(const S7200WriteBuffer& other)
+{
+    size_t base = _data.size();
+    _data.insert(_data.end(), other._data.begin(), other._data.end());
+    for(const auto& write : other._writes)
+        _writes.push_back(Write{write.target, base + write.offset, write.critical});
+}
+
+void S7200WriteBuffer::retain(const std::vector<bool>& sent)
+{
+    size_t kept = 0;
+    size_t end = 0;
+    for(size_t i = 0; i < _writes.size(); i++) {
+        if(sent[i])
+            continue;
+        Write write = _writes[i];
+        // the values only move towards the front
+        std::memmove(_data.data() + end, _data.data() + write.offset, write.target->size);
+        write.offset = end;
+        end += write.target->size;
+        _writes[kept++] = write;
+    }
+    _writes.resize(kept);
+    _data.resize(end);
+}
+
+size_t S7200WriteBuffer::keepLatest()
+{
+    // from the end: a write is superseded when a later write goes to the same address
+    std::unordered_set<const Target*> written;
+    _superseded.assign(_writes.size(), false);
+    size_t dropped = 0;
+    for(size_t i = _writes.size(); i-- > 0; ) {
+        if(!written.insert(_writes[i].target).second) {
+            _superseded[i] = true;
+            dropped++;
+        }
+    }
+    if(dropped > 0)
+        retain(_superseded);
+    return dropped;
+}
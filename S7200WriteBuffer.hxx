@@ -0,0 +1,92 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#ifndef S7200WRITEBUFFER_HXX
+#define S7200WRITEBUFFER_HXX
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <sys/types.h>
+#include "snap7.h"
+
+/**
+ * @brief The S7200WriteBuffer class holds the writes queued for one PLC, already encoded in the PLC format
+ *
+ * The target of an address (area, start, size) is compiled once per PLC. A value is encoded from the bytes given
+ * by its transformation (big endian, width of the DPE type) straight into one pooled buffer, converted when the
+ * width of the DPE type is not the one of the address (e.g. an int DPE on a VD address). The writes are sent from
+ * this buffer. Two buffers are swapped between the main thread and the polling thread and keep their capacity,
+ * so once warmed up queuing and sending writes allocates nothing.
+ */
+class S7200WriteBuffer
+{
+public:
+    // How the bytes given by the transformation are interpreted
+    enum class Kind { Raw, Signed, Unsigned, Float };
+
+    /**
+     * @brief An address written to, compiled once
+     */
+    struct Target
+    {
+        std::string var;
+        TS7DataItem item; // pdata is set when sending
+        int size{0};      // bytes
+    };
+
+    struct Write
+    {
+        const Target* target;
+        size_t offset;    // of the value in the buffer
+        bool critical;    // not held back by the write limiter
+    };
+
+    /**
+     * @brief Encode a value at the end of the buffer
+     * @param target : the address written to
+     * @param kind : interpretation of the value
+     * @param value : the value given by the transformation, in PLC byte order
+     * @param length : its size
+     * @param critical : sent before the other writes, not held back by the write limiter
+     * @return false if the value cannot be written to this address
+     * */
+    bool push(const Target& target, Kind kind, const char* value, size_t length, bool critical = false);
+
+    const std::vector<Write>& writes() const {return _writes;}
+    char* data(const Write& write) {return _data.data() + write.offset;}
+    bool empty() const {return _writes.empty();}
+    size_t size() const {return _writes.size();}
+
+    void clear();
+    void swap(S7200WriteBuffer& other);
+    // Append the writes of another buffer
+    void append(const S7200WriteBuffer& other);
+    // Keep only the writes not sent, in their order
+    void retain(const std::vector<bool>& sent);
+    /**
+     * @brief Keep only the last write of each address, in the order of these last writes
+     * @return the number of writes dropped
+     * */
+    size_t keepLatest();
+
+private:
+    std::vector<Write> _writes;
+    std::vector<char> _data;
+    std::vector<bool> _superseded;
+
+    static bool convert(const Target& target, Kind kind, const char* value, size_t length, char* out);
+};
+
+#endif //S7200WRITEBUFFER_HXX
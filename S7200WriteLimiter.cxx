@@ -0,0 +1,56 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#include "S7200WriteLimiter.hxx"
+
+#include <algorithm>
+
+void S7200WriteLimiter::configure(int frameRate, int byteRate)
+{
+    if(frameRate == _frameRate && byteRate == _byteRate)
+        return;
+    _frameRate = std::max(0, frameRate);
+    _byteRate = std::max(0, byteRate);
+    _frames = _frameRate;
+    _bytes = _byteRate;
+    _last = std::chrono::steady_clock::now();
+}
+
+void S7200WriteLimiter::refill(std::chrono::time_point<std::chrono::steady_clock> now)
+{
+    double elapsed = std::chrono::duration<double>(now - _last).count();
+    if(elapsed <= 0)
+        return;
+    _last = now;
+    _frames = std::min<double>(_frameRate, _frames + elapsed * _frameRate);
+    _bytes = std::min<double>(_byteRate, _bytes + elapsed * _byteRate);
+}
+
+bool S7200WriteLimiter::tryAcquire(int bytes, std::chrono::time_point<std::chrono::steady_clock> now)
+{
+    if(!isLimited())
+        return true;
+
+    refill(now);
+    if(_frameRate > 0 && _frames < 1)
+        return false;
+    if(_byteRate > 0 && _bytes < std::min(bytes, _byteRate))
+        return false;
+
+    if(_frameRate > 0)
+        _frames -= 1;
+    if(_byteRate > 0)
+        _bytes -= bytes;
+    return true;
+}
@@ -0,0 +1,57 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#ifndef S7200WRITELIMITER_HXX
+#define S7200WRITELIMITER_HXX
+
+#include <chrono>
+
+/**
+ * @brief The S7200WriteLimiter class caps the write requests sent to one PLC: token buckets of frames per second
+ * and bytes per second
+ *
+ * Each bucket holds at most one second of its rate, so a burst of writes (e.g. a recipe) is spread over the
+ * following cycles instead of stretching the scan cycle of the PLC. A frame bigger than the byte bucket is sent
+ * once the bucket is full, the bucket then goes below zero. A rate of 0 does not limit.
+ */
+class S7200WriteLimiter
+{
+public:
+    /**
+     * @brief Set the rates, the buckets start full
+     * @param frameRate : write requests per second, 0 = unlimited
+     * @param byteRate : bytes written per second, 0 = unlimited
+     * */
+    void configure(int frameRate, int byteRate);
+
+    bool isLimited() const {return _frameRate > 0 || _byteRate > 0;}
+
+    /**
+     * @brief Take the tokens of one write request
+     * @param bytes : size of the values of the request
+     * @return false if the request must wait, no token is taken then
+     * */
+    bool tryAcquire(int bytes, std::chrono::time_point<std::chrono::steady_clock> now);
+
+private:
+    void refill(std::chrono::time_point<std::chrono::steady_clock> now);
+
+    int _frameRate{0};
+    int _byteRate{0};
+    double _frames{0};
+    double _bytes{0};
+    std::chrono::time_point<std::chrono::steady_clock> _last;
+};
+
+#endif //S7200WRITELIMITER_HXX
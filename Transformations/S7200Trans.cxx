@@ -12,27 +12,27 @@
  *
  **/
 
-// Our transformation class PVSS <--> Hardware
-#include "S7200StringTrans.hxx"
+// Our transformation class PVSS <--> Hardware for character buffers.
+// The fixed size types are fully defined in S7200Trans.hxx
+#include "S7200Trans.hxx"
 #include <ErrHdl.hxx>     // The Error handler Basics/Utilities
 
 
-#include "S7200HWMapper.hxx"
-
 #include "Common/Logger.hxx"
+#include "Common/StringCodec.hxx"
+
+#include <algorithm>
 
 //----------------------------------------------------------------------------
 namespace Transformations {
 
 
-//S7200StringTrans::S7200StringTrans() : Transformation() { }
-
-TransformationType S7200StringTrans::isA() const
+TransformationType S7200Trans<S7200Text>::isA() const
 {
   return (TransformationType) S7200DrvStringTransType;
 }
 
-TransformationType S7200StringTrans::isA(TransformationType type) const {
+TransformationType S7200Trans<S7200Text>::isA(TransformationType type) const {
     if (type == isA())
         return type;
     else
@@ -43,31 +43,30 @@ TransformationType S7200StringTrans::isA(TransformationType type) const {
 
 //----------------------------------------------------------------------------
 
-Transformation *S7200StringTrans::clone() const
+Transformation *S7200Trans<S7200Text>::clone() const
 {
-  return new S7200StringTrans;
+  return new S7200Trans(_itemSize, _s7Header);
 }
 
 //----------------------------------------------------------------------------
-// Our item size. The max we will use is 256 Bytes.
-// This is an arbitrary value! A Transformation for a long e.g. would return 4
+// Our item size: the size of the PLC buffer given by the address (e.g. 40 for VB100.40,
+// 42 for VB100.40S). Config DPEs without a PLC address fall back to defaultSize.
 
-int S7200StringTrans::itemSize() const
+int S7200Trans<S7200Text>::itemSize() const
 {
-  // TODO - check maximum possible size
-  return _size;
+  return _itemSize;
 }
 
 //----------------------------------------------------------------------------
 // Our preferred Variable type. Data will be converted to this type
 // before toPeriph is called.
 
-VariableType S7200StringTrans::getVariableType() const
+VariableType S7200Trans<S7200Text>::getVariableType() const
 {
   return TEXT_VAR;
 }
 
-PVSSboolean S7200StringTrans::toPeriph(PVSSchar *buffer, PVSSuint len,
+PVSSboolean S7200Trans<S7200Text>::toPeriph(PVSSchar *buffer, PVSSuint len,
                                       const Variable &var, const PVSSuint subix) const
 {
 
@@ -88,44 +87,43 @@ PVSSboolean S7200StringTrans::toPeriph(PVSSchar *buffer, PVSSuint len,
 
   // Check data len. TextVar::getString returns a CharString
   const TextVar& tv = static_cast<const TextVar &>(var);
-  if (len < tv.getString().len() + 1)
+  PVSSuint size = std::min(len, static_cast<PVSSuint>(_itemSize));
+  if (!Common::StringCodec::encode(buffer, size, _s7Header, tv.getValue(), tv.getString().len()))
   {
     // Throw error message
     ErrHdl::error(
       ErrClass::PRIO_SEVERE,             // Data will be lost
-      ErrClass::ERR_IMPL,                // Mus be implementation
+      ErrClass::ERR_PARAM,               // Wrong parametrization
       ErrClass::UNEXPECTEDSTATE,         // Nothing else appropriate
-      "S7200StringTrans::toPeriph",       // File and function name
-      "Data buffer too small; need:" +
-      CharString(tv.getString().len() + 1) +
-      " have:" + CharString(len)
+      "S7200Trans<S7200Text>::toPeriph",       // File and function name
+      "String too long; need:" +
+      CharString(tv.getString().len()) +
+      " have:" + CharString(size)
     );
 
     return PVSS_FALSE;
   }
 
-  if(tv.getString().len() > 1024 * 10 ){
-      ErrHdl::error(ErrClass::PRIO_SEVERE, // Data will be lost
-              ErrClass::ERR_PARAM, // Wrong parametrization
-              ErrClass::UNEXPECTEDSTATE, // Nothing else appropriate
-              "S7200StringTrans::toPeriph",       // File and function name
-              "String too long" // Unfortunately we don't know which DP
-              );
-
-      return PVSS_FALSE;
-  }
-
-  sprintf((char*)buffer, "%s%c", tv.getValue(), '\0');
-
   return PVSS_TRUE;
 }
 
-VariablePtr S7200StringTrans::toVar(const PVSSchar *buffer, const PVSSuint dlen,
+VariablePtr S7200Trans<S7200Text>::toVar(const PVSSchar *buffer, const PVSSuint dlen,
                                    const PVSSuint /* subix */) const
 {
-  std::string strVal(reinterpret_cast<char const*>(buffer));
-  PVSSuint strSize = std::min({static_cast<PVSSuint>(strVal.length()), static_cast<PVSSuint>(dlen-1)});
-  return new TextVar(strVal.c_str(), strSize);
+  if (buffer == NULL)
+  {
+    ErrHdl::error(ErrClass::PRIO_SEVERE, // Data will be lost
+            ErrClass::ERR_PARAM, // Wrong parametrization
+            ErrClass::UNEXPECTEDSTATE, // Nothing else appropriate
+            "S7200StringTrans", "toVar", // File and function name
+            "Null buffer pointer" // Unfortunately we don't know which DP
+            );
+    return NULL;
+  }
+
+  size_t strSize;
+  const char* strVal = Common::StringCodec::decode(buffer, std::min(dlen, static_cast<PVSSuint>(_itemSize)), _s7Header, strSize);
+  return new TextVar(strVal, strSize);
 }
 
 
@@ -0,0 +1,386 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#ifndef S7200TRANS_HXX_
+#define S7200TRANS_HXX_
+
+#include <Transformation.hxx>
+#include <ErrHdl.hxx>
+#include <BitVar.hxx>
+#include <IntegerVar.hxx>
+#include <UIntegerVar.hxx>
+#include <FloatVar.hxx>
+#include <TextVar.hxx>
+#include <DynVar.hxx>
+
+#include "S7200HWMapper.hxx"
+
+#include <cstring>
+#include <stdint.h>
+
+namespace Transformations {
+
+/*!
+ * Byte order of a value in the PLC memory. S7 CPUs are big endian.
+ */
+enum class Endian { Big, Little };
+
+/*!
+ * Tag type for character buffers (VB100.40, VB100.40S)
+ */
+struct S7200Text {};
+
+template <size_t Width> struct S7200Raw;
+template <> struct S7200Raw<1> { typedef uint8_t type; };
+template <> struct S7200Raw<2> { typedef uint16_t type; };
+template <> struct S7200Raw<4> { typedef uint32_t type; };
+template <> struct S7200Raw<8> { typedef uint64_t type; };
+
+/*!
+ * \struct S7200Codec
+ * \brief Decoding/encoding of one PLC value of Width bytes to/from its C++ type
+ */
+template <typename T, Endian E, size_t Width>
+struct S7200Codec
+{
+	static_assert(sizeof(T) == Width, "PLC width must match the C++ type size");
+	typedef typename S7200Raw<Width>::type Raw;
+
+	static T decode(const PVSSchar *data)
+	{
+		Raw raw = 0;
+		for(size_t i = 0; i < Width; i++)
+			raw |= static_cast<Raw>(data[i]) << (8 * (E == Endian::Big ? Width - 1 - i : i));
+		T value;
+		std::memcpy(&value, &raw, Width);
+		return value;
+	}
+
+	static void encode(T value, PVSSchar *data)
+	{
+		Raw raw;
+		std::memcpy(&raw, &value, Width);
+		for(size_t i = 0; i < Width; i++)
+			data[i] = static_cast<PVSSchar>(raw >> (8 * (E == Endian::Big ? Width - 1 - i : i)));
+	}
+};
+
+// S7 sends 1 byte per bit; any non zero byte is true
+template <Endian E>
+struct S7200Codec<bool, E, 1>
+{
+	static bool decode(const PVSSchar *data) { return data[0] != 0; }
+	static void encode(bool value, PVSSchar *data) { data[0] = value ? 1 : 0; }
+};
+
+/*!
+ * \struct S7200TransTraits
+ * \brief WinCC OA side of a PLC type: transformation type, Variable class and conversions
+ */
+template <typename T> struct S7200TransTraits;
+
+template <> struct S7200TransTraits<bool>
+{
+	typedef BitVar Var;
+	static TransformationType type() { return (TransformationType) S7200DrvBoolTransType; }
+	static VariableType variableType() { return BIT_VAR; }
+	static VariableType dynVariableType() { return DYNBIT_VAR; }
+	static const char *name() { return "S7200BoolTrans"; }
+	static bool fromVar(const Variable &var) { return static_cast<const BitVar &>(var).getValue(); }
+};
+
+template <> struct S7200TransTraits<uint8_t>
+{
+	typedef IntegerVar Var;
+	static TransformationType type() { return (TransformationType) S7200DrvUint8TransType; }
+	static VariableType variableType() { return INTEGER_VAR; }
+	static VariableType dynVariableType() { return DYNINTEGER_VAR; }
+	static const char *name() { return "S7200Uint8Trans"; }
+	// WinCC OA handles the number as int32, any info above the 8 first bits is lost
+	static uint8_t fromVar(const Variable &var) { return (uint8_t) static_cast<const IntegerVar &>(var).getValue(); }
+};
+
+template <> struct S7200TransTraits<int16_t>
+{
+	typedef IntegerVar Var;
+	static TransformationType type() { return (TransformationType) S7200DrvInt16TransType; }
+	static VariableType variableType() { return INTEGER_VAR; }
+	static VariableType dynVariableType() { return DYNINTEGER_VAR; }
+	static const char *name() { return "S7200Int16Trans"; }
+	// WinCC OA handles the number as int32, any info above the 16 first bits is lost
+	static int16_t fromVar(const Variable &var) { return (int16_t) static_cast<const IntegerVar &>(var).getValue(); }
+};
+
+template <> struct S7200TransTraits<uint16_t>
+{
+	typedef IntegerVar Var;
+	static TransformationType type() { return (TransformationType) S7200DrvUint16TransType; }
+	static VariableType variableType() { return INTEGER_VAR; }
+	static VariableType dynVariableType() { return DYNINTEGER_VAR; }
+	static const char *name() { return "S7200Uint16Trans"; }
+	static uint16_t fromVar(const Variable &var) { return (uint16_t) static_cast<const IntegerVar &>(var).getValue(); }
+};
+
+template <> struct S7200TransTraits<int32_t>
+{
+	typedef IntegerVar Var;
+	static TransformationType type() { return (TransformationType) S7200DrvInt32TransType; }
+	static VariableType variableType() { return INTEGER_VAR; }
+	static VariableType dynVariableType() { return DYNINTEGER_VAR; }
+	static const char *name() { return "S7200Int32Trans"; }
+	static int32_t fromVar(const Variable &var) { return (int32_t) static_cast<const IntegerVar &>(var).getValue(); }
+};
+
+template <> struct S7200TransTraits<uint32_t>
+{
+	typedef UIntegerVar Var;
+	static TransformationType type() { return (TransformationType) S7200DrvUint32TransType; }
+	static VariableType variableType() { return UINTEGER_VAR; }
+	static VariableType dynVariableType() { return DYNUINTEGER_VAR; }
+	static const char *name() { return "S7200Uint32Trans"; }
+	static uint32_t fromVar(const Variable &var) { return (uint32_t) static_cast<const UIntegerVar &>(var).getValue(); }
+};
+
+template <> struct S7200TransTraits<float>
+{
+	typedef FloatVar Var;
+	static TransformationType type() { return (TransformationType) S7200DrvFloatTransType; }
+	static VariableType variableType() { return FLOAT_VAR; }
+	static VariableType dynVariableType() { return DYNFLOAT_VAR; }
+	static const char *name() { return "S7200FloatTrans"; }
+	static float fromVar(const Variable &var) { return (float) static_cast<const FloatVar &>(var).getValue(); }
+};
+
+template <> struct S7200TransTraits<double>
+{
+	typedef FloatVar Var;
+	static TransformationType type() { return (TransformationType) S7200DrvDoubleTransType; }
+	static VariableType variableType() { return FLOAT_VAR; }
+	static VariableType dynVariableType() { return DYNFLOAT_VAR; }
+	static const char *name() { return "S7200DoubleTrans"; }
+	static double fromVar(const Variable &var) { return static_cast<const FloatVar &>(var).getValue(); }
+};
+
+/*!
+ * \class S7200Trans
+ * \brief Transformation PVSS <--> Hardware for a fixed size PLC value
+ *
+ * The item size and the conversions are resolved at compile time; a new PLC type
+ * only needs a S7200TransTraits specialization and a typedef below.
+ */
+template <typename T, Endian E = Endian::Big, size_t Width = sizeof(T)>
+class S7200Trans: public Transformation {
+public:
+	typedef T Value;
+	typedef S7200TransTraits<T> Traits;
+	typedef S7200Codec<T, E, Width> Codec;
+
+	static constexpr size_t size() { return Width; }
+
+	/*!
+	 *  Transformations typ
+	 *  \return transformation type
+	 */
+	TransformationType isA() const { return Traits::type(); }
+
+	/*!
+	 *  Transformations typ comparison
+	 *  \param type object to return type
+	 *  \return transformation type
+	 */
+	TransformationType isA(TransformationType type) const
+	{
+		if (type == isA())
+			return type;
+		else
+			return Transformation::isA(type);
+	}
+
+	/*!
+	 * Size of transformation buffer
+	 * \return size of buffer
+	 */
+	int itemSize() const { return (int) Width; }
+
+	/*!
+	 * The type of Variable we are expecting here
+	 * \return actual variable type
+	 */
+	VariableType getVariableType() const { return Traits::variableType(); }
+
+	/*!
+	 *  Clone of our class
+	 *  \return pointer to new object
+	 */
+	Transformation *clone() const { return new S7200Trans; }
+
+	/*!
+	 * Conversion from PVSS to Hardware
+	 * \param dataPtr pointer to buffer where data will be written
+	 * \param len size of data buffer
+	 * \param var reference to current translated value
+	 * \param subix subindex of value in data point
+	 * \return flag if translation was successful
+	 */
+	PVSSboolean toPeriph(PVSSchar *dataPtr, PVSSuint len, const Variable &var, const PVSSuint subix) const
+	{
+		if(var.isA() != Traits::variableType() || len < Width * (subix + 1)){
+			ErrHdl::error(ErrClass::PRIO_SEVERE, // Data will be lost
+					ErrClass::ERR_PARAM, // Wrong parametrization
+					ErrClass::UNEXPECTEDSTATE, // Nothing else appropriate
+					Traits::name(), "toPeriph", // File and function name
+					"Wrong variable type or wrong length: " + CharString(len) + ", subix: " + CharString(subix) // Unfortunately we don't know which DP
+					);
+			return PVSS_FALSE;
+		}
+
+		Codec::encode(Traits::fromVar(var), dataPtr + (subix * Width));
+		return PVSS_TRUE;
+	}
+
+	/*!
+	 * Conversion from Hardware to PVSS
+	 * \param data pointer to buffer from where data will be read
+	 * \param dlen length of data buffer
+	 * \param subix subindex of value associated with peripheral address
+	 * \return flag if translation was successful
+	 */
+	VariablePtr toVar(const PVSSchar *data, const PVSSuint dlen, const PVSSuint subix) const
+	{
+		if(data == NULL || dlen < Width * (subix + 1)){
+			ErrHdl::error(ErrClass::PRIO_SEVERE, // Data will be lost
+					ErrClass::ERR_PARAM, // Wrong parametrization
+					ErrClass::UNEXPECTEDSTATE, // Nothing else appropriate
+					Traits::name(), "toVar", // File and function name
+					"Null buffer pointer or wrong length: " + CharString(dlen) // Unfortunately we don't know which DP
+					);
+			return NULL;
+		}
+
+		return new typename Traits::Var(Codec::decode(data + (subix * Width)));
+	}
+};
+
+/*!
+ * \class S7200ArrayTrans
+ * \brief Transformation PVSS <--> Hardware for a block of PLC values (e.g. VW200[64]) and a dyn DPE
+ *
+ * The whole block is read as one item; the subindex of the periphery address is the
+ * first element mapped to the dyn DPE.
+ */
+template <typename T, Endian E = Endian::Big, size_t Width = sizeof(T)>
+class S7200ArrayTrans: public Transformation {
+public:
+	typedef S7200TransTraits<T> Traits;
+	typedef S7200Codec<T, E, Width> Codec;
+
+	S7200ArrayTrans(size_t count) : _count(count) {}
+
+	TransformationType isA() const { return Traits::type(); }
+
+	TransformationType isA(TransformationType type) const
+	{
+		if (type == isA())
+			return type;
+		else
+			return Transformation::isA(type);
+	}
+
+	int itemSize() const { return (int) (Width * _count); }
+
+	VariableType getVariableType() const { return Traits::dynVariableType(); }
+
+	Transformation *clone() const { return new S7200ArrayTrans(_count); }
+
+	PVSSboolean toPeriph(PVSSchar *dataPtr, PVSSuint len, const Variable &var, const PVSSuint subix) const
+	{
+		const DynVar &dyn = static_cast<const DynVar &>(var);
+		if(var.isA() != Traits::dynVariableType() || len < Width * (subix + dyn.getNumberOfItems())){
+			ErrHdl::error(ErrClass::PRIO_SEVERE, // Data will be lost
+					ErrClass::ERR_PARAM, // Wrong parametrization
+					ErrClass::UNEXPECTEDSTATE, // Nothing else appropriate
+					Traits::name(), "toPeriph", // File and function name
+					"Wrong variable type or wrong length: " + CharString(len) + ", subix: " + CharString(subix) // Unfortunately we don't know which DP
+					);
+			return PVSS_FALSE;
+		}
+
+		for(DynPtrArrayIndex i = 0; i < dyn.getNumberOfItems(); i++)
+			Codec::encode(Traits::fromVar(*dyn.getAt(i)), dataPtr + ((subix + i) * Width));
+		return PVSS_TRUE;
+	}
+
+	VariablePtr toVar(const PVSSchar *data, const PVSSuint dlen, const PVSSuint subix) const
+	{
+		if(data == NULL || dlen < Width * (subix + 1)){
+			ErrHdl::error(ErrClass::PRIO_SEVERE, // Data will be lost
+					ErrClass::ERR_PARAM, // Wrong parametrization
+					ErrClass::UNEXPECTEDSTATE, // Nothing else appropriate
+					Traits::name(), "toVar", // File and function name
+					"Null buffer pointer or wrong length: " + CharString(dlen) // Unfortunately we don't know which DP
+					);
+			return NULL;
+		}
+
+		DynVar *dyn = new DynVar(Traits::variableType());
+		for(PVSSuint i = subix; i < _count && Width * (i + 1) <= dlen; i++)
+			dyn->append(new typename Traits::Var(Codec::decode(data + (i * Width))));
+		return dyn;
+	}
+
+private:
+	size_t _count;
+};
+
+/*!
+ * \class S7200Trans<S7200Text>
+ * \brief Transformation PVSS <--> Hardware for character buffers
+ *
+ * The size is only known at runtime (from the address), see Common::StringCodec
+ */
+template <>
+class S7200Trans<S7200Text, Endian::Big, 1>: public Transformation {
+public:
+	// size is the number of bytes of the PLC buffer, S7 STRING header included
+	S7200Trans(size_t size = defaultSize, bool s7Header = false) : _itemSize(size), _s7Header(s7Header) {}
+
+	// Config DPEs without a PLC address fall back to 10 KB
+	static const size_t defaultSize = 1024 * 10;
+
+	TransformationType isA() const;
+	TransformationType isA(TransformationType type) const;
+	int itemSize() const;
+	VariableType getVariableType() const;
+	Transformation *clone() const;
+	PVSSboolean toPeriph(PVSSchar *dataPtr, PVSSuint len, const Variable &var, const PVSSuint subix) const;
+	VariablePtr toVar(const PVSSchar *data, const PVSSuint dlen, const PVSSuint subix) const;
+
+private:
+	size_t _itemSize;
+	bool _s7Header;
+};
+
+typedef S7200Trans<bool>      S7200BoolTrans;
+typedef S7200Trans<uint8_t>   S7200Uint8Trans;
+typedef S7200Trans<int16_t>   S7200Int16Trans;
+typedef S7200Trans<uint16_t>  S7200Uint16Trans;   // WORD
+typedef S7200Trans<int32_t>   S7200Int32Trans;    // DINT
+typedef S7200Trans<uint32_t>  S7200Uint32Trans;   // UDINT, DWORD
+typedef S7200Trans<float>     S7200FloatTrans;    // REAL
+typedef S7200Trans<double>    S7200DoubleTrans;   // LREAL
+typedef S7200Trans<S7200Text> S7200StringTrans;
+
+}//namespace
+
+#endif /* S7200TRANS_HXX_ */
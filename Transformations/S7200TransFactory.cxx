@@ -0,0 +1,103 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#include "S7200TransFactory.hxx"
+#include "S7200Trans.hxx"
+
+#include "S7200LibFacade.hxx"
+
+namespace Transformations {
+
+namespace {
+
+template <class Trans>
+Transformation *make() { return new Trans; }
+
+template <class Trans>
+Transformation *makeArray(size_t count) { return new S7200ArrayTrans<typename Trans::Value>(count); }
+
+struct S7200TransEntry
+{
+	TransformationType type;
+	int wordLen;       // address word length this transformation is the default for, -1 if none
+	int size;          // bytes in the PLC, 0 if given by the address
+	Transformation *(*create)();
+	Transformation *(*createArray)(size_t count);
+};
+
+// One line per transformation type
+const S7200TransEntry entries[] = {
+	{ (TransformationType) S7200DrvBoolTransType,   S7WLBit,  (int) S7200BoolTrans::size(),   &make<S7200BoolTrans>,   &makeArray<S7200BoolTrans> },
+	{ (TransformationType) S7200DrvUint8TransType,  S7WLByte, (int) S7200Uint8Trans::size(),  &make<S7200Uint8Trans>,  &makeArray<S7200Uint8Trans> },
+	{ (TransformationType) S7200DrvInt16TransType,  S7WLWord, (int) S7200Int16Trans::size(),  &make<S7200Int16Trans>,  &makeArray<S7200Int16Trans> },
+	{ (TransformationType) S7200DrvUint16TransType, -1,       (int) S7200Uint16Trans::size(), &make<S7200Uint16Trans>, &makeArray<S7200Uint16Trans> },
+	{ (TransformationType) S7200DrvInt32TransType,  -1,       (int) S7200Int32Trans::size(),  &make<S7200Int32Trans>,  &makeArray<S7200Int32Trans> },
+	{ (TransformationType) S7200DrvUint32TransType, -1,       (int) S7200Uint32Trans::size(), &make<S7200Uint32Trans>, &makeArray<S7200Uint32Trans> },
+	{ (TransformationType) S7200DrvFloatTransType,  S7WLReal, (int) S7200FloatTrans::size(),  &make<S7200FloatTrans>,  &makeArray<S7200FloatTrans> },
+	{ (TransformationType) S7200DrvDoubleTransType, -1,       (int) S7200DoubleTrans::size(), &make<S7200DoubleTrans>, &makeArray<S7200DoubleTrans> },
+	{ (TransformationType) S7200DrvStringTransType, -1,       0,                              &make<S7200StringTrans>, NULL },
+};
+
+const S7200TransEntry *findByType(TransformationType type)
+{
+	for(const auto &entry : entries)
+		if(entry.type == type)
+			return &entry;
+	return NULL;
+}
+
+const S7200TransEntry *findByWordLen(int wordLen)
+{
+	for(const auto &entry : entries)
+		if(entry.wordLen == wordLen)
+			return &entry;
+	return NULL;
+}
+
+}
+
+Transformation *S7200TransFactory::create(TransformationType type)
+{
+	const S7200TransEntry *entry = findByType(type);
+	return entry ? entry->create() : NULL;
+}
+
+Transformation *S7200TransFactory::createForAddress(const std::string &address, TransformationType type)
+{
+	if(!S7200LibFacade::S7200AddressIsValid(address))
+		return NULL;
+
+	int size = S7200LibFacade::getByteSizeFromAddress(address);
+	int wordLen = S7200LibFacade::S7200AddressGetWordLen(address);
+	const S7200TransEntry *entry = findByType(type);
+
+	if(S7200LibFacade::S7200AddressIsArray(address))
+	{
+		int count = S7200LibFacade::S7200AddressGetAmount(address);
+		if(!entry || !entry->createArray || entry->size * count != size)
+			entry = findByWordLen(wordLen);
+		return entry && entry->createArray ? entry->createArray(count) : NULL;
+	}
+
+	if(entry && entry->size == size)
+		return entry->create();
+
+	if(wordLen == S7WLByte && S7200LibFacade::S7200AddressGetAmount(address) > 1)
+		return new S7200StringTrans(size, S7200LibFacade::S7200AddressIsS7String(address));
+
+	entry = findByWordLen(wordLen);
+	return entry ? entry->create() : NULL;
+}
+
+}//namespace
@@ -0,0 +1,50 @@
+/** © Copyright 2023 CERN
+ *
+ * This software is distributed under the terms of the
+ * GNU Lesser General Public Licence version 3 (LGPL Version 3),
+ * copied verbatim in the file “LICENSE”
+ *
+ * In applying this licence, CERN does not waive the privileges
+ * and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ *
+ * Author: Adrien Ledeul (HSE), Richi Dubey (HSE)
+ *
+ **/
+
+#ifndef S7200TRANSFACTORY_HXX_
+#define S7200TRANSFACTORY_HXX_
+
+#include <Transformation.hxx>
+#include <string>
+
+namespace Transformations {
+
+/*!
+ * \class S7200TransFactory
+ * \brief Table driven creation of the S7200 transformations
+ */
+class S7200TransFactory {
+public:
+	/*!
+	 * Transformation for an address without PLC memory (config DPEs, _Error)
+	 * \param type transformation type selected in the periphery address
+	 * \return new transformation, NULL if the type is unknown
+	 */
+	static Transformation *create(TransformationType type);
+
+	/*!
+	 * Transformation for a PLC address (e.g. VW304, VB100.40, V255.3, VD400[32])
+	 * The type selected in the periphery address is used when its size matches the
+	 * address (e.g. Int32 for VD124), otherwise the default type of the address is used.
+	 * Array addresses get an array transformation of the element type.
+	 * \param address PLC address
+	 * \param type transformation type selected in the periphery address
+	 * \return new transformation, NULL if the address is unexpected
+	 */
+	static Transformation *createForAddress(const std::string &address, TransformationType type);
+};
+
+}//namespace
+
+#endif /* S7200TRANSFACTORY_HXX_ */